@@ -6,80 +6,87 @@
 #include "colors.h"
 
 
-std::string MemoryOperand::toString() const {
-	if ((*_symbolTable)[_index]._name.size() == 0) {
-		return "TMP" + std::to_string(_index);
+const char* atomName(AtomOp op) {
+	switch (op) {
+	case AtomOp::mov: return "MOV";
+	case AtomOp::neg: return "NEG";
+	case AtomOp::opnot: return "NOT";
+	case AtomOp::add: return "ADD";
+	case AtomOp::sub: return "SUB";
+	case AtomOp::opand: return "AND";
+	case AtomOp::opor: return "OR";
+	case AtomOp::mul: return "MUL";
+	case AtomOp::div: return "DIV";
+	case AtomOp::out: return "OUT";
+	case AtomOp::in: return "IN";
+	case AtomOp::label: return "LBL";
+	case AtomOp::jmp: return "JMP";
+	case AtomOp::eq: return "EQ";
+	case AtomOp::ne: return "NE";
+	case AtomOp::gt: return "GT";
+	case AtomOp::lt: return "LT";
+	case AtomOp::le: return "LE";
+	case AtomOp::call: return "CALL";
+	case AtomOp::ret: return "RET";
+	case AtomOp::param: return "PARAM";
 	}
-	else {
-		return (*_symbolTable)[_index]._name;
-	}
-}
-
-std::string NumberOperand::toString() const {
-	std::ostringstream oss;
-	oss << "\'" << _value << "\'";
-	return oss.str();
+	return "?";
 }
 
-std::string StringOperand::toString() const {
-	std::ostringstream oss;
-	oss << "\"";
-	oss << (*_stringTable)[_index];
-	oss << "\"";
-	return oss.str();
-}
 
-std::string LabelOperand::toString() const {
+std::string AtomWriter::toString(const Operand& operand) const {
 	std::ostringstream oss;
-	oss << "L" << _labelID;
+	switch (operand.kind()) {
+	case OperandKind::memory:
+		if (_symbolTable[operand.value()]._name == Interner::Empty)
+			oss << "TMP" << operand.value();
+		else
+			oss << _symbolTable.name(operand.value());
+		break;
+	case OperandKind::number:
+		oss << "\'" << operand.value() << "\'";
+		break;
+	case OperandKind::string:
+		oss << "\"" << _stringTable[operand.value()] << "\"";
+		break;
+	case OperandKind::label:
+		oss << "L" << operand.value();
+		break;
+	case OperandKind::none:
+		break;
+	}
 	return oss.str();
 }
 
 
+void AtomWriter::load(std::ostream& stream, const Operand& operand, int shift) const {
+	if (operand.kind() == OperandKind::number) {
+		stream << '\t' << "MVI A, " << operand.value() << '\n';
+		return;
+	}
 
-void MemoryOperand::load(std::ostream& stream, int shift) const {
+	auto& record = _symbolTable[operand.value()];
 	// Global
-	if ((*_symbolTable)[_index]._scope == GlobalScope) {
-		int count = 0;
-		for (int i = 0; i < _index; ++i) {
-			if ((*_symbolTable)[i]._kind == SymbolTable::TableRecord::RecordKind::var and
-				(*_symbolTable)[i]._scope == GlobalScope)
-			{
-				count += 1;
-			}
-		}
-		stream << '\t' << "LDA var" << count << '\n';
+	if (record._scope == GlobalScope) {
+		stream << '\t' << "LDA var" << record._dataIndex << '\n';
 	}
 	else {
-		int offset = (*_symbolTable)[_index]._offset;
+		int offset = record._offset;
 		stream << '\t' << "LXI H, " << offset + shift << '\n';
 		stream << '\t' << "DAD sp" << '\n';
 		stream << '\t' << "MOV A, M" << '\n';
 	}
 }
 
-void NumberOperand::load(std::ostream& stream, int shift) const {
-	int value = this->_value;
-	stream << '\t' << "MVI A, " << value << '\n';
-}
-
-
 
-void MemoryOperand::save(std::ostream& stream, int shift) const {
+void AtomWriter::save(std::ostream& stream, const Operand& operand, int shift) const {
+	auto& record = _symbolTable[operand.value()];
 	// Global
-	if ((*_symbolTable)[_index]._scope == GlobalScope) {
-		int count = 0;
-		for (int i = 0; i < _index; ++i) {
-			if ((*_symbolTable)[i]._kind == SymbolTable::TableRecord::RecordKind::var and
-				(*_symbolTable)[i]._scope == GlobalScope)
-			{
-				count += 1;
-			}
-		}
-		stream << '\t' << "STA var" << count << '\n';
+	if (record._scope == GlobalScope) {
+		stream << '\t' << "STA var" << record._dataIndex << '\n';
 	}
 	else {
-		int offset = (*_symbolTable)[_index]._offset;
+		int offset = record._offset;
 		stream << '\t' << "LXI H, " << offset + shift << '\n';
 		stream << '\t' << "DAD sp" << '\n';
 		stream << '\t' << "MOV M, A" << '\n';
@@ -93,42 +100,71 @@ void MemoryOperand::save(std::ostream& stream, int shift) const {
 */
 
 
-std::string UnaryOpAtom::toString() const {
+std::string AtomWriter::toString(const Atom& atom) const {
 	std::ostringstream oss;
-	oss << "[" << _name << ", ";
-	if (_operand != nullptr)
-		oss << _operand->toString() << ",, ";
-	else
-		oss << "nullptr,, ";
-	if (_result != nullptr)
-		oss << _result->toString() << "]";
-	else
-		oss << "nullptr]";
-
+	switch (atom.op) {
+	case AtomOp::mov:
+	case AtomOp::neg:
+	case AtomOp::opnot:
+		oss << "[" << atomName(atom.op) << ", " << toString(atom.first) << ",, " << toString(atom.result) << "]";
+		break;
+	case AtomOp::out:
+	case AtomOp::in:
+	case AtomOp::label:
+	case AtomOp::jmp:
+		oss << "[" << atomName(atom.op) << ",,, " << toString(atom.result) << "]";
+		break;
+	case AtomOp::call:
+		oss << "[CALL, " << toString(atom.first) << ", , " << toString(atom.result) << "]";
+		break;
+	case AtomOp::ret:
+	case AtomOp::param:
+		oss << "[" << atomName(atom.op) << ", ,,, " << toString(atom.result) << "]";
+		break;
+	default:
+		// Áèíàðíûå îïåðàöèè è óñëîâíûå ïåðåõîäû
+		oss << "[" << atomName(atom.op) << ", " << toString(atom.first) << ", " << toString(atom.second) << ", " << toString(atom.result) << "]";
+		break;
+	}
 	return oss.str();
 }
 
-void UnaryOpAtom::generate(std::ostream& stream) const {
+
+void AtomWriter::comment(std::ostream& stream, const Atom& atom) const {
 	stream << "\t\t\t";
 	SetColor(ConsoleColor::Blue, ConsoleColor::White);
-	stream << "; " << this->toString();
+	stream << "; " << toString(atom);
 	SetColor(ConsoleColor::Black, ConsoleColor::White);
 	stream << '\n';
+}
+
 
-	if (_name == "MOV") {
-		_operand->load(stream);
-		_result->save(stream);
+void AtomWriter::generate(std::ostream& stream, const Atom& atom) const {
+	if (atom.op == AtomOp::call or atom.op == AtomOp::ret or atom.op == AtomOp::param) {
+		std::ostringstream err_msg;
+		err_msg << "Àòîì [" << atomName(atom.op) << "] ïîðîæäàåòñÿ òîëüêî â generateFunction.";
+		throw std::exception(err_msg.str().c_str());
 	}
-	else if (_name == "NEG") {
-		_operand->load(stream);
+
+	comment(stream, atom);
+
+	switch (atom.op) {
+	case AtomOp::mov:
+		load(stream, atom.first);
+		save(stream, atom.result);
+		break;
+
+	case AtomOp::neg:
+		load(stream, atom.first);
 		stream << '\t' << "MOV B, A" << '\n';
 		stream << '\t' << "MVI A, 0" << '\n';
 		stream << '\t' << "SUB B" << '\n';
-		_result->save(stream);
-	}
-	else if (_name == "NOT") {
+		save(stream, atom.result);
+		break;
+
+	case AtomOp::opnot: {
 		static int count = 0;
-		_operand->load(stream);
+		load(stream, atom.first);
 		stream << '\t' << "CPI 0" << '\n';
 		stream << '\t' << "MVI A, 1" << '\n';
 
@@ -137,284 +173,83 @@ void UnaryOpAtom::generate(std::ostream& stream) const {
 
 		stream << "\nN" << count++ << ":\n";
 
-		 _result->save(stream);
+		save(stream, atom.result);
+		break;
 	}
-	else {
-		std::ostringstream err_msg;
-		err_msg << "Íåèçâåñòíûé ÀÒÎÌ â UnaryOpAtom : [";
-		err_msg << _name;
-		err_msg << "] .";
-		throw std::exception(err_msg.str().c_str());
-	}
-}
-
-
-
-
-
-std::string BinaryOpAtom::toString() const {
-	std::ostringstream oss;
-	oss << '[';
-	oss << _name << ", ";
-	if (_left != nullptr)
-		oss << _left->toString() << ", ";
-	else
-		oss << "nullptr, ";
-	if (_right != nullptr)
-		oss << _right->toString() << ", ";
-	else
-		oss << "nullptr, ";
-	if (_result != nullptr)
-		oss << _result->toString();
-	else
-		oss << "nullptr";
-	oss << ']';
-
-	return oss.str();
-}
-void BinaryOpAtom::generate(std::ostream& stream) const {
-	stream << "\t\t\t";
-	SetColor(ConsoleColor::Blue, ConsoleColor::White);
-	stream << "; " << this->toString();
-	SetColor(ConsoleColor::Black, ConsoleColor::White);
-	stream << '\n';
-
-
 
-	_right->load(stream);
-	if (_name == "MUL" or _name == "DIV")
-		stream << '\t' << "MOV D, A" << '\n';
-	else
+	case AtomOp::add:
+	case AtomOp::sub:
+	case AtomOp::opand:
+	case AtomOp::opor:
+		load(stream, atom.second);
 		stream << '\t' << "MOV B, A" << '\n';
-	_left->load(stream);
-	if (_name == "MUL" or _name == "DIV")
+		load(stream, atom.first);
+		stream << '\t' << atomName(atom.op) << " B" << '\n';
+		save(stream, atom.result);
+		break;
+
+	case AtomOp::mul:
+	case AtomOp::div:
+		load(stream, atom.second);
+		stream << '\t' << "MOV D, A" << '\n';
+		load(stream, atom.first);
 		stream << '\t' << "MOV C, A" << '\n';
-	
-
-	generateOperation(stream);
-
-	if (_name == "MUL" or _name == "DIV")
+		stream << '\t' << (atom.op == AtomOp::mul ? "CALL @MULT" : "CALL @DIV") << '\n';
 		stream << '\t' << "MOV A, C" << '\n';
-	_result->save(stream);
-}
-
+		save(stream, atom.result);
+		break;
 
-
-
-std::string OutAtom::toString() const {
-	std::ostringstream oss;
-	oss << "[OUT,,, " << _value->toString() << ']';
-	return oss.str();
-}
-void OutAtom::generate(std::ostream& stream) const {
-	stream << "\t\t\t";
-	SetColor(ConsoleColor::Blue, ConsoleColor::White);
-	stream << "; " << this->toString();
-	SetColor(ConsoleColor::Black, ConsoleColor::White);
-	stream << '\n';
-
-	auto s_lab = std::dynamic_pointer_cast<StringOperand>(this->_value);
-	if (s_lab != nullptr) {
-		stream << '\t' << "LXI A, str" << s_lab->_index << '\n';
-		stream << '\t' << "CALL @PRINT" << '\n';
-	}
-	else {
-		auto mem_op = std::dynamic_pointer_cast<MemoryOperand>(this->_value);
-		if (mem_op != nullptr) {
-			mem_op->load(stream);
+	case AtomOp::out:
+		if (atom.result.kind() == OperandKind::string) {
+			stream << '\t' << "LXI A, str" << atom.result.value() << '\n';
+			stream << '\t' << "CALL @PRINT" << '\n';
+		}
+		else if (atom.result.kind() == OperandKind::memory or atom.result.kind() == OperandKind::number) {
+			load(stream, atom.result);
 			stream << '\t' << "OUT 1" << '\n';
 		}
-		else {
-			auto num_op = std::dynamic_pointer_cast<NumberOperand>(this->_value);
-			if (num_op != nullptr) {
-				num_op->load(stream);
-				stream << '\t' << "OUT 1" << '\n';
-			}
-			else
-				throw std::exception("âûâîä íå ñòðîêè è íå ïåðåìåííîé.");
+		else
+			throw std::exception("âûâîä íå ñòðîêè è íå ïåðåìåííîé.");
+		break;
+
+	case AtomOp::in:
+		stream << '\t' << "IN 0" << '\n';
+		save(stream, atom.result);
+		break;
+
+	case AtomOp::label:
+		stream << toString(atom.result) << ':' << '\n';
+		break;
+
+	case AtomOp::jmp:
+		stream << '\t' << "JMP " << toString(atom.result) << '\n';
+		break;
+
+	case AtomOp::eq:
+	case AtomOp::ne:
+	case AtomOp::gt:
+	case AtomOp::lt:
+	case AtomOp::le: {
+		load(stream, atom.second);
+		stream << '\t' << "MOV B, A" << '\n';
+		load(stream, atom.first);
+
+		std::string label = toString(atom.result);
+		stream << '\t' << "CMP B" << '\n';
+		switch (atom.op) {
+		case AtomOp::eq: stream << '\t' << "JZ " << label << '\n'; break;
+		case AtomOp::ne: stream << '\t' << "JNZ " << label << '\n'; break;
+		case AtomOp::gt: stream << '\t' << "JP " << label << '\n'; break;
+		case AtomOp::lt: stream << '\t' << "JM " << label << '\n'; break;
+		default:
+			stream << '\t' << "JZ " << label << '\n';
+			stream << '\t' << "JM " << label << '\n';
+			break;
 		}
+		break;
 	}
-}
-
-
-
-std::string InAtom::toString() const {
-	std::ostringstream oss;
-	oss << "[IN,,, " << _result->toString() << ']';
-	return oss.str();
-}
-void InAtom::generate(std::ostream& stream) const {
-	stream << "\t\t\t";
-	SetColor(ConsoleColor::Blue, ConsoleColor::White);
-	stream << "; " << this->toString();
-	SetColor(ConsoleColor::Black, ConsoleColor::White);
-	stream << '\n';
 
-
-	stream << '\t' << "IN 0" << '\n';
-	_result->save(stream);
-}
-
-
-std::string LabelAtom::toString() const {
-	std::ostringstream oss;
-	oss << "[LBL,,, " << _label->toString() << ']';
-	return oss.str();
-}
-void LabelAtom::generate(std::ostream& stream) const {
-	stream << "\t\t\t";
-	SetColor(ConsoleColor::Blue, ConsoleColor::White);
-	stream << "; " << this->toString();
-	SetColor(ConsoleColor::Black, ConsoleColor::White);
-	stream << '\n';
-
-
-	stream << this->_label->toString() << ':' << '\n';
-}
-
-
-std::string JumpAtom::toString() const {
-	std::ostringstream oss;
-	oss << "[JMP,,, " << _label->toString() << ']';
-	return oss.str();
-}
-void JumpAtom::generate(std::ostream& stream) const {
-	stream << "\t\t\t";
-	SetColor(ConsoleColor::Blue, ConsoleColor::White);
-	stream << "; " << this->toString();
-	SetColor(ConsoleColor::Black, ConsoleColor::White);
-	stream << '\n';
-
-
-	stream << '\t' << "JMP " << this->_label->toString() << '\n';
-}
-
-
-
-std::string ConditionalJumpAtom::toString() const {
-	std::ostringstream oss;
-	oss << '[';
-	oss << _condition << ", ";
-	oss << _left->toString() << ", ";
-	oss << _right->toString() << ", ";
-	oss << _label->toString();
-	oss << ']';
-
-	return oss.str();
-}
-void ConditionalJumpAtom::generate(std::ostream& stream) const {
-	stream << "\t\t\t";
-	SetColor(ConsoleColor::Blue, ConsoleColor::White);
-	stream << "; " << this->toString();
-	SetColor(ConsoleColor::Black, ConsoleColor::White);
-	stream << '\n';
-
-
-	_right->load(stream);
-	stream << '\t' << "MOV B, A" << '\n';
-	_left->load(stream);
-
-	generateOperation(stream);
-}
-
-
-
-
-std::string CallAtom::toString() const {
-	std::ostringstream oss;
-	oss << "[CALL, " << _func->toString() << ", , ";
-	oss << _ret->toString() << "]";
-
-	return oss.str();
-}
-void CallAtom::generate(std::ostream& stream) const {
-	throw std::exception("CALL");
-}
-
-
-
-
-std::string RetAtom::toString() const {
-	std::ostringstream oss;
-	oss << "[RET, " << ",,, ";
-	oss << _ret->toString() << "]";
-
-	return oss.str();
-}
-void RetAtom::generate(std::ostream& stream) const {
-	throw std::exception("RET");
-
-
-
-	stream << "\t\t\t";
-	SetColor(ConsoleColor::Blue, ConsoleColor::White);
-	stream << "; " << this->toString();
-	SetColor(ConsoleColor::Black, ConsoleColor::White);
-	stream << '\n';
-
-}
-
-
-
-std::string ParamAtom::toString() const {
-	std::ostringstream oss;
-	oss << "[PARAM, " << ",,, ";
-	oss << _param->toString() << "]";
-
-	return oss.str();
-}
-void ParamAtom::generate(std::ostream& stream) const {
-	throw std::exception("PARAM");
-
-
-	stream << "\t\t\t";
-	SetColor(ConsoleColor::Blue, ConsoleColor::White);
-	stream << "; " << this->toString();
-	SetColor(ConsoleColor::Black, ConsoleColor::White);
-	stream << '\n';
-
-
-}
-
-
-
-
-
-
-void SimpleBinaryOpAtom::generateOperation(std::ostream& stream) const {
-	stream << '\t' << _name << " B" << '\n';
-}
-
-void FnBinaryOpAtom::generateOperation(std::ostream& stream) const {
-	if (_name == "MUL")
-		stream << '\t' << "CALL @MULT" << '\n';
-	else if (_name == "DIV")
-		stream << '\t' << "CALL @DIV" << '\n';
-}
-
-
-void SimpleConditionalJumpAtom::generateOperation(std::ostream& stream) const {
-	stream << '\t' << "CMP B" << '\n';
-	if (_condition == "EQ")
-		stream << '\t' << "JZ " << _label->toString() << '\n';
-	else if (_condition == "NE")
-		stream << '\t' << "JNZ " << _label->toString() << '\n';
-	else if (_condition == "GT")
-		stream << '\t' << "JP " << _label->toString() << '\n';
-	else if (_condition == "LT")
-		stream << '\t' << "JM " << _label->toString() << '\n';
-	else {
-		std::ostringstream err_msg;
-		err_msg << "Íåèçâåñòíîå óñëîâèå â SimpleConditionalJumpAtom : [ ";
-		err_msg << _condition;
-		err_msg << " ] .";
-		throw std::exception(err_msg.str().c_str());
+	default:
+		break;
 	}
 }
-
-void ComplexConditionalJumpAtom::generateOperation(std::ostream& stream) const {
-	stream << '\t' << "CMP B" << '\n';
-
-	stream << '\t' << "JZ " << _label->toString() << '\n';
-	stream << '\t' << "JM " << _label->toString() << '\n';
-}
@@ -1,65 +1,45 @@
 #pragma once
+#include <cstdint>
 #include <ostream>
 #include <string>
-#include <memory>
 
 class StringTable;
 class SymbolTable;
 
-class Operand {
-public:
-	virtual std::string toString() const = 0;
-};
-
-
-class RValue: public Operand {
-public:
-	virtual void load(std::ostream& stream, int shift = 0) const = 0;
-};
-
-
-class MemoryOperand : public RValue {
-public:
-	int _index;
-	const SymbolTable* _symbolTable;
-
-	MemoryOperand(int index, SymbolTable* symbolTable) : _index{ index }, _symbolTable{ symbolTable } {}
-	int index() const { return _index; };
-	std::string toString() const override;
-	void load(std::ostream& stream, int shift = 0) const override;
-	void save(std::ostream& stream, int shift = 0) const;
-};
-
-
-class NumberOperand : public RValue {
-protected:
-	int _value;
+// Âèä îïåðàíäà àòîìà
+enum class OperandKind : uint8_t { none, memory, number, string, label };
 
+// Îïåðàíä àòîìà: âèä â ñòàðøèõ 3 áèòàõ è íîìåð èëè çíà÷åíèå â îñòàëüíûõ 29.
+// Íîìåð çàïèñè ðàçðåøàåò òàáëèöà ñèìâîëîâ, íîìåð ñòðîêè - òàáëèöà ñòðîê, íîìåð ìåòêè - ñàì ïî ñåáå.
+// Êîïèðóåòñÿ ïî çíà÷åíèþ, ïóñòîé îïåðàíä (none) ðàâåí íóëþ
+class Operand {
 public:
-	NumberOperand(int value) : _value{ value } {};
-	std::string toString() const override;
-	void load(std::ostream& stream, int shift = 0) const override;
-};
+	static constexpr int KindBits = 3;
+	static constexpr int PayloadBits = 32 - KindBits;
+	// Äèàïàçîí íåïîñðåäñòâåííîãî ÷èñëà
+	static constexpr int MinNumber = -(1 << (PayloadBits - 1));
+	static constexpr int MaxNumber = (1 << (PayloadBits - 1)) - 1;
 
+	constexpr Operand() : _bits{ 0 } {}
 
-class StringOperand : public Operand {
-public:
-	int _index;
-	const StringTable* _stringTable;
+	static constexpr Operand memory(int index) { return Operand{ OperandKind::memory, index }; }
+	static constexpr Operand number(int value) { return Operand{ OperandKind::number, value }; }
+	static constexpr Operand string(int index) { return Operand{ OperandKind::string, index }; }
+	static constexpr Operand label(int id) { return Operand{ OperandKind::label, id }; }
 
+	constexpr OperandKind kind() const { return static_cast<OperandKind>(_bits >> PayloadBits); }
+	// Íîìåð èëè çíà÷åíèå; ÷èñëî âîññòàíàâëèâàåòñÿ ñî çíàêîì
+	constexpr int value() const { return static_cast<int32_t>(_bits << KindBits) >> KindBits; }
 
-	StringOperand(int index, StringTable* stringTable) : _index{ index }, _stringTable{ stringTable } {}
-	std::string toString() const override;
-};
+	constexpr explicit operator bool() const { return _bits != 0; }
 
+private:
+	constexpr Operand(OperandKind kind, int value) :
+		_bits{ (static_cast<uint32_t>(kind) << PayloadBits) | (static_cast<uint32_t>(value) & PayloadMask) } {}
 
-class LabelOperand : Operand {
-protected:
-	int _labelID;
+	static constexpr uint32_t PayloadMask = (1u << PayloadBits) - 1;
 
-public:
-	LabelOperand(int labelID) : _labelID{ labelID } {}
-	std::string toString() const override;
+	uint32_t _bits;
 };
 
 
@@ -69,207 +49,47 @@ public:
 * ##################################################################
 */
 
-class Atom {
-public:
-	virtual std::string toString() const = 0;
-	virtual void generate(std::ostream&) const = 0;
+// Îïåðàöèÿ àòîìà
+enum class AtomOp : uint8_t {
+	mov, neg, opnot,					// [op, a,, result]
+	add, sub, opand, opor, mul, div,	// [op, a, b, result]
+	out, in, label, jmp,				// [op,,, result]
+	eq, ne, gt, lt, le,					// [op, a, b, ìåòêà]
+	call,								// [CALL, ôóíêöèÿ, , result]
+	ret, param							// [op, ,,, result]
 };
 
-class UnaryOpAtom : public Atom {
-protected:
-	std::string _name;
-	std::shared_ptr<RValue> _operand;
-	std::shared_ptr<MemoryOperand> _result;
-public:
-	UnaryOpAtom(const std::string& name,
-				std::shared_ptr<RValue> operand,
-				std::shared_ptr<MemoryOperand> result) :
-		_name{ name }, _operand{ operand }, _result{ result } {};
+// Èìÿ îïåðàöèè â ðàñïå÷àòêå àòîìîâ
+const char* atomName(AtomOp);
 
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
+// Àòîì õðàíèòñÿ ïî çíà÷åíèþ â íåïðåðûâíîì ìàññèâå àòîìîâ ñâîåé ôóíêöèè.
+// Íåèñïîëüçóåìûå îïåðàíäû èìåþò âèä none
+struct Atom {
+	AtomOp op;
+	Operand first;
+	Operand second;
+	Operand result;
 };
 
 
-class BinaryOpAtom : public Atom {
-protected:
-	std::string _name;
-	std::shared_ptr<RValue> _left;
-	std::shared_ptr<RValue> _right;
-	std::shared_ptr<MemoryOperand> _result;
-
-	virtual void generateOperation(std::ostream&) const = 0;
-
+// Ðàñïå÷àòêà àòîìîâ è ïîðîæäåíèå ïî íèì êîäà: îïåðàíäû ðàçðåøàþòñÿ ÷åðåç òàáëèöû ñèìâîëîâ è ñòðîê
+class AtomWriter {
 public:
-	BinaryOpAtom(const std::string& name,
-		std::shared_ptr<RValue> left,
-		std::shared_ptr<RValue> right,
-		std::shared_ptr<MemoryOperand> result) :
-		_name{ name }, _left{ left }, _right{ right }, _result{ result } {};
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
-};
-
+	AtomWriter(const SymbolTable& symbolTable, const StringTable& stringTable) :
+		_symbolTable{ symbolTable }, _stringTable{ stringTable } {};
 
-class SimpleBinaryOpAtom : public BinaryOpAtom {
-protected:
-	void generateOperation(std::ostream&) const override;
+	std::string toString(const Operand&) const;
+	std::string toString(const Atom&) const;
 
-public:
-	SimpleBinaryOpAtom(const std::string& name,
-		std::shared_ptr<RValue> left,
-		std::shared_ptr<RValue> right,
-		std::shared_ptr<MemoryOperand> result) :
-		BinaryOpAtom{name, left, right, result} {};
-};
-
-class FnBinaryOpAtom : public BinaryOpAtom {
-protected:
-	void generateOperation(std::ostream&) const override;
-
-public:
-	FnBinaryOpAtom(const std::string& name,
-		std::shared_ptr<RValue> left,
-		std::shared_ptr<RValue> right,
-		std::shared_ptr<MemoryOperand> result) :
-		BinaryOpAtom{ name, left, right, result } {};
-};
-
-
-
-
-
-
-class OutAtom : public Atom {
-protected:
-	std::shared_ptr<Operand> _value;
-
-public:
-	OutAtom(std::shared_ptr<Operand> value) : _value{ value } {};
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
-};
-
-
-class InAtom : public Atom {
-protected:
-	std::shared_ptr<MemoryOperand> _result;
-
-public:
-	InAtom(std::shared_ptr<MemoryOperand> result) : _result{ result } {};
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
-};
-
-
-class LabelAtom : public Atom {
-protected:
-	std::shared_ptr<LabelOperand> _label;
-
-public:
-	LabelAtom(std::shared_ptr<LabelOperand> label) : _label{ label } {};
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
-};
-
-
-class JumpAtom : public Atom {
-protected:
-	std::shared_ptr<LabelOperand> _label;
-
-public:
-	JumpAtom(std::shared_ptr<LabelOperand> label) : _label{ label } {};
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
-};
-
-
-class ConditionalJumpAtom : public Atom {
-protected:
-	std::string _condition;
-	std::shared_ptr<RValue> _left;
-	std::shared_ptr<RValue> _right;
-	std::shared_ptr<LabelOperand> _label;
-
-	virtual void generateOperation(std::ostream&) const = 0;
-
-public:
-	ConditionalJumpAtom(const std::string& condition,
-						std::shared_ptr<RValue> left,
-						std::shared_ptr<RValue> right,
-						std::shared_ptr<LabelOperand> label) :
-		_condition{ condition }, _left{ left }, _right{ right }, _label{ label } {};
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
-};
-
-
-class SimpleConditionalJumpAtom : public ConditionalJumpAtom {
-protected:
-	void generateOperation(std::ostream&) const override;
-
-public:
-	SimpleConditionalJumpAtom(const std::string& condition,
-		std::shared_ptr<RValue> left,
-		std::shared_ptr<RValue> right,
-		std::shared_ptr<LabelOperand> label) :
-		ConditionalJumpAtom{ condition ,left , right, label } {};
-};
-
-class ComplexConditionalJumpAtom : public ConditionalJumpAtom {
-protected:
-	void generateOperation(std::ostream&) const override;
-
-public:
-	ComplexConditionalJumpAtom(const std::string& condition,
-		std::shared_ptr<RValue> left,
-		std::shared_ptr<RValue> right,
-		std::shared_ptr<LabelOperand> label) :
-		ConditionalJumpAtom{ condition ,left , right, label } {};
-};
-
-
-
-
-
-
-
-
-
-
-class CallAtom : public Atom {
-public:
-
-	std::shared_ptr<MemoryOperand> _func;
-	std::shared_ptr<MemoryOperand> _ret;
-
-
-	CallAtom(std::shared_ptr<MemoryOperand> func, std::shared_ptr<MemoryOperand> ret) : _func{ func }, _ret{ ret }{}
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
-};
-
-
-
-class RetAtom : public Atom {
-
-public:
-	std::shared_ptr<RValue> _ret;
-
-
-	RetAtom(std::shared_ptr<RValue> ret) : _ret{ ret } {}
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
-};
-
-
-
-class ParamAtom : public Atom {
-public:
-	std::shared_ptr<RValue> _param;
+	void load(std::ostream& stream, const Operand&, int shift = 0) const;
+	void save(std::ostream& stream, const Operand&, int shift = 0) const;
 
+	// Êîììåíòàðèé ñ òåêñòîì àòîìà ïåðåä åãî êîäîì
+	void comment(std::ostream& stream, const Atom&) const;
+	// Êîä àòîìà. PARAM, CALL è RET çàâèñÿò îò êàäðà ôóíêöèè, èõ ïîðîæäàåò Translator::generateFunction
+	void generate(std::ostream& stream, const Atom&) const;
 
-	ParamAtom(std::shared_ptr<RValue> param) : _param{ param } {}
-	std::string toString() const override;
-	void generate(std::ostream&) const override;
+private:
+	const SymbolTable& _symbolTable;
+	const StringTable& _stringTable;
 };
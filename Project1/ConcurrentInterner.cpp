@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <functional>
+
+#include "ConcurrentInterner.h"
+
+
+ConcurrentInterner::Table::Table(size_t size) : mask{ size - 1 }, slots{ new std::atomic<Entry*>[size] } {
+	for (size_t i = 0; i < size; ++i)
+		slots[i].store(nullptr, std::memory_order_relaxed);
+}
+
+
+ConcurrentInterner::ConcurrentInterner() : _shards{ new Shard[Shards] } {
+	for (uint32_t s = 0; s < Shards; ++s) {
+		Shard& shard = _shards[s];
+		shard.tables.emplace_back(new Table(InitialSlots));
+		shard.table.store(shard.tables.back().get(), std::memory_order_release);
+		for (int b = 0; b < MaxBlocks; ++b)
+			shard.blocks[b].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+
+ConcurrentInterner::~ConcurrentInterner() {
+	for (uint32_t s = 0; s < Shards; ++s) {
+		for (int b = 0; b < MaxBlocks; ++b)
+			delete[] _shards[s].blocks[b].load(std::memory_order_relaxed);
+	}
+}
+
+
+void ConcurrentInterner::locate(uint32_t index, int& block, uint32_t& offset) {
+	block = 0;
+	offset = index;
+	for (uint32_t size = FirstBlock; offset >= size; size *= 2) {
+		offset -= size;
+		++block;
+	}
+}
+
+
+const ConcurrentInterner::Entry& ConcurrentInterner::entry(uint32_t id) const {
+	int block;
+	uint32_t offset;
+	locate(id >> ShardBits, block, offset);
+	return _shards[id & (Shards - 1)].blocks[block].load(std::memory_order_acquire)[offset];
+}
+
+
+size_t ConcurrentInterner::hash(std::string_view text) {
+	return std::hash<std::string_view>()(text);
+}
+
+
+ConcurrentInterner::Entry* ConcurrentInterner::probe(const Table& table, size_t hash, std::string_view text) {
+	// Ìëàäøèå áèòû õåøà óæå âûáðàëè ñåãìåíò
+	for (size_t i = (hash >> ShardBits) & table.mask;; i = (i + 1) & table.mask) {
+		Entry* entry = table.slots[i].load(std::memory_order_acquire);
+		if (entry == nullptr or (entry->hash == hash and entry->text == text))
+			return entry;
+	}
+}
+
+
+void ConcurrentInterner::lower(std::atomic<uint64_t>& order, uint64_t value) {
+	uint64_t current = order.load(std::memory_order_relaxed);
+	while (value < current and !order.compare_exchange_weak(current, value, std::memory_order_relaxed))
+		;
+}
+
+
+uint32_t ConcurrentInterner::find(std::string_view text) const {
+	size_t h = hash(text);
+	const Shard& shard = _shards[h & (Shards - 1)];
+	Entry* entry = probe(*shard.table.load(std::memory_order_acquire), h, text);
+	return entry == nullptr ? NotFound : entry->id;
+}
+
+
+uint32_t ConcurrentInterner::intern(std::string_view text, uint64_t order) {
+	size_t h = hash(text);
+	Shard& shard = _shards[h & (Shards - 1)];
+
+	// ×àùå âñåãî òåêñò óæå åñòü: áåç áëîêèðîâêè
+	Entry* entry = probe(*shard.table.load(std::memory_order_acquire), h, text);
+	if (entry != nullptr) {
+		lower(entry->order, order);
+		return entry->id;
+	}
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	// Ïîêà æäàëè, òåêñò ìîãëè âñòàâèòü èëè òàáëèöó ìîãëè çàìåíèòü
+	Table* table = shard.table.load(std::memory_order_relaxed);
+	entry = probe(*table, h, text);
+	if (entry != nullptr) {
+		lower(entry->order, order);
+		return entry->id;
+	}
+
+	uint32_t index = shard.count;
+	int b;
+	uint32_t offset;
+	locate(index, b, offset);
+	if (b >= MaxBlocks)
+		throw std::exception("ConcurrentInterner: ïåðåïîëíåíèå ñåãìåíòà");
+	std::atomic<Entry*>& block = shard.blocks[b];
+	if (block.load(std::memory_order_relaxed) == nullptr)
+		block.store(new Entry[static_cast<size_t>(FirstBlock) << b], std::memory_order_release);
+
+	entry = &block.load(std::memory_order_relaxed)[offset];
+	entry->hash = h;
+	entry->text = store(shard, text);
+	entry->id = (index << ShardBits) | static_cast<uint32_t>(h & (Shards - 1));
+	entry->order.store(order, std::memory_order_relaxed);
+
+	// Çàïèñü âèäíà ÷èòàòåëÿì òîëüêî ïîñëå òîãî, êàê çàïîëíåíà
+	size_t i = (h >> ShardBits) & table->mask;
+	while (table->slots[i].load(std::memory_order_relaxed) != nullptr)
+		i = (i + 1) & table->mask;
+	table->slots[i].store(entry, std::memory_order_release);
+
+	++shard.count;
+	_count.fetch_add(1, std::memory_order_release);
+	if (2 * shard.count > table->mask + 1)
+		grow(shard);
+	return entry->id;
+}
+
+
+void ConcurrentInterner::grow(Shard& shard) {
+	Table* old = shard.table.load(std::memory_order_relaxed);
+	shard.tables.emplace_back(new Table(2 * (old->mask + 1)));
+	Table* table = shard.tables.back().get();
+
+	for (size_t i = 0; i <= old->mask; ++i) {
+		Entry* entry = old->slots[i].load(std::memory_order_relaxed);
+		if (entry == nullptr)
+			continue;
+		size_t j = (entry->hash >> ShardBits) & table->mask;
+		while (table->slots[j].load(std::memory_order_relaxed) != nullptr)
+			j = (j + 1) & table->mask;
+		table->slots[j].store(entry, std::memory_order_relaxed);
+	}
+	// Ñòàðóþ òàáëèöó åù¸ ìîãóò ÷èòàòü, îíà îñâîáîæäàåòñÿ âìåñòå ñ èíòåðíåðîì
+	shard.table.store(table, std::memory_order_release);
+}
+
+
+std::string_view ConcurrentInterner::store(Shard& shard, std::string_view text) {
+	// Ïóñòîé ñòðîêå ìåñòî íå íóæíî; äî ïåðâîãî áëîêà textBlock åù¸ ïóñò, è ñäâèãàòü åãî íåëüçÿ
+	if (text.empty())
+		return std::string_view();
+
+	char* place;
+
+	// Äëèííûå òåêñòû ïîëó÷àþò ñîáñòâåííûé áëîê, îñòàëüíûå äîïèñûâàþòñÿ â òåêóùèé
+	if (text.size() > TextBlockSize) {
+		shard.textBlocks.emplace_back(new char[text.size()]);
+		place = shard.textBlocks.back().get();
+	}
+	else {
+		if (shard.textUsed + text.size() > TextBlockSize) {
+			shard.textBlocks.emplace_back(new char[TextBlockSize]);
+			shard.textBlock = shard.textBlocks.back().get();
+			shard.textUsed = 0;
+		}
+		place = shard.textBlock + shard.textUsed;
+		shard.textUsed += text.size();
+	}
+
+	std::memcpy(place, text.data(), text.size());
+	return std::string_view(place, text.size());
+}
+
+
+std::string_view ConcurrentInterner::operator [](uint32_t id) const {
+	return entry(id).text;
+}
+
+
+std::vector<uint32_t> ConcurrentInterner::renumber() const {
+	std::vector<const Entry*> entries;
+	uint32_t largest = 0;
+	for (uint32_t s = 0; s < Shards; ++s) {
+		largest = std::max(largest, _shards[s].count);
+		for (uint32_t index = 0; index < _shards[s].count; ++index)
+			entries.push_back(&entry((index << ShardBits) | s));
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) {
+		uint64_t x = a->order.load(std::memory_order_relaxed), y = b->order.load(std::memory_order_relaxed);
+		return x != y ? x < y : a->text < b->text;
+	});
+
+	std::vector<uint32_t> result(static_cast<size_t>(largest) << ShardBits, NotFound);
+	for (size_t i = 0; i < entries.size(); ++i)
+		result[entries[i]->id] = static_cast<uint32_t>(i);
+	return result;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// Òàáëèöà òåêñòîâ, â êîòîðóþ îäíîâðåìåííî ïèøóò íåñêîëüêî ïîòîêîâ (ñòðîêè ôóíêöèé ïðè ïàðàëëåëüíîì ðàçáîðå).
+// Ïîèñê èä¸ò áåç áëîêèðîâîê. Âñòàâêà áëîêèðóåò îäèí èç Shards ñåãìåíòîâ, âûáðàííûé ïî õåøó òåêñòà.
+// Íîìåð, âûäàííûé intern, íå ìåíÿåòñÿ, íî çàâèñèò îò òîãî, â êàêîì ïîðÿäêå ïðèøëè ïîòîêè. Ïîýòîìó
+// âìåñòå ñ òåêñòîì ïåðåäà¸òñÿ êëþ÷ ïîðÿäêà - ìåñòî âõîæäåíèÿ â ïîñëåäîâàòåëüíîì ðàçáîðå, è ïîñëå
+// âñåõ âñòàâîê renumber() âûäà¸ò ïëîòíûå íîìåðà ïî íàèìåíüøåìó êëþ÷ó êàæäîãî òåêñòà - òå æå ïðè ëþáîì ðàñïèñàíèè.
+// Òåêñòû è çàïèñè íå ïåðåìåùàþòñÿ, ïîêà æèâà òàáëèöà; ñòàðûå õåø-òàáëèöû ñåãìåíòîâ ïîñëå ðîñòà
+// òîæå îñòàþòñÿ äî å¸ óíè÷òîæåíèÿ, ïîòîìó ÷òî èõ åù¸ ìîãóò ÷èòàòü
+class ConcurrentInterner {
+public:
+	static constexpr uint32_t NotFound = UINT32_MAX;
+
+	ConcurrentInterner();
+	~ConcurrentInterner();
+
+	ConcurrentInterner(const ConcurrentInterner&) = delete;
+	ConcurrentInterner& operator = (const ConcurrentInterner&) = delete;
+
+	// Íîìåð òåêñòà; íîâûé òåêñò êîïèðóåòñÿ â òàáëèöó. order - êëþ÷ ïîðÿäêà ýòîãî âõîæäåíèÿ
+	uint32_t intern(std::string_view text, uint64_t order = 0);
+	// Íîìåð òåêñòà èëè NotFound
+	uint32_t find(std::string_view text) const;
+	// Òåêñò ïî íîìåðó èç intern
+	std::string_view operator [] (uint32_t id) const;
+	// Âñåãî òåêñòîâ
+	size_t size() const { return _count.load(std::memory_order_acquire); };
+
+	// Âûçûâàåòñÿ, êîãäà âñòàâêè çàêîí÷èëèñü. Íîâûå íîìåðà 0..size()-1 ïî âîçðàñòàíèþ íàèìåíüøåãî
+	// êëþ÷à ïîðÿäêà (ïðè ðàâíûõ êëþ÷àõ - ïî òåêñòó), èíäåêñ - íîìåð èç intern; íåâûäàííûå íîìåðà - NotFound
+	std::vector<uint32_t> renumber() const;
+
+private:
+	static constexpr int ShardBits = 6;
+	static constexpr uint32_t Shards = 1u << ShardBits;
+	// Çàïèñè ñåãìåíòà ëåæàò áëîêàìè, áëîê b âìåùàåò FirstBlock * 2^b çàïèñåé è íå ïåðåìåùàåòñÿ.
+	// Íîìåð çàïèñè - å¸ ìåñòî â ñåãìåíòå è íîìåð ñåãìåíòà â ìëàäøèõ ShardBits áèòàõ, ìåíüøå 2^29 (Operand::string)
+	static constexpr uint32_t FirstBlock = 256;
+	static constexpr int MaxBlocks = 15;
+	static constexpr size_t TextBlockSize = 16 * 1024;
+	static constexpr size_t InitialSlots = 16;
+
+	struct Entry {
+		size_t hash;
+		std::string_view text;
+		uint32_t id;
+		std::atomic<uint64_t> order;
+	};
+
+	// Îòêðûòàÿ àäðåñàöèÿ ñ ëèíåéíûì ïðîáèðîâàíèåì; çàïîëíåíèå íå âûøå ïîëîâèíû
+	struct Table {
+		size_t mask;
+		std::unique_ptr<std::atomic<Entry*>[]> slots;
+		explicit Table(size_t size);
+	};
+
+	struct Shard {
+		std::atomic<Table*> table{ nullptr };
+		std::atomic<Entry*> blocks[MaxBlocks];
+		// Äàëüøå - òîëüêî ïîä mutex
+		std::mutex mutex;
+		uint32_t count = 0;
+		std::vector<std::unique_ptr<Table>> tables;
+		std::vector<std::unique_ptr<char[]>> textBlocks;
+		char* textBlock = nullptr;
+		size_t textUsed = TextBlockSize;
+	};
+
+	static size_t hash(std::string_view text);
+	static Entry* probe(const Table& table, size_t hash, std::string_view text);
+	static void lower(std::atomic<uint64_t>& order, uint64_t value);
+	// Áëîê çàïèñè ñ ìåñòîì index â ñåãìåíòå è å¸ ìåñòî â áëîêå
+	static void locate(uint32_t index, int& block, uint32_t& offset);
+	const Entry& entry(uint32_t id) const;
+	std::string_view store(Shard& shard, std::string_view text);
+	void grow(Shard& shard);
+
+	std::unique_ptr<Shard[]> _shards;
+	std::atomic<size_t> _count{ 0 };
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Atoms.h"
+#include "Token.h"
+
+// Òàáëèöà áèíàðíûõ îïåðàòîðîâ âûðàæåíèé äëÿ ðàçáîðà ïî ïðèîðèòåòàì.
+// Ñòðîèòñÿ íà ýòàïå êîìïèëÿöèè: òèï ëåêñåìû -> ñèëà ñâÿçûâàíèÿ è ñïîñîá ïîðîæäåíèÿ àòîìîâ.
+// Íîâûé îïåðàòîð äîáàâëÿåòñÿ ñòðîêîé â makeBinaryOperators().
+
+// Ñïîñîá ïîðîæäåíèÿ àòîìîâ
+enum class BinaryForm : uint8_t {
+	none,			// íå áèíàðíûé îïåðàòîð
+	simple,			// îïåðàöèÿ íàä ðåãèñòðàìè A è B
+	function,		// îïåðàöèÿ áèáëèîòå÷íîé ôóíêöèåé
+	compare,		// ñðàâíåíèå: óñëîâíûé ïåðåõîä è 0/1 â ðåçóëüòàòå
+	complexCompare	// ñðàâíåíèå ÷åðåç äâà óñëîâíûõ ïåðåõîäà
+};
+
+constexpr bool isComparison(BinaryForm form) {
+	return form == BinaryForm::compare or form == BinaryForm::complexCompare;
+}
+
+struct BinaryOperator {
+	// Ñèëà ñâÿçûâàíèÿ: ÷åì áîëüøå, òåì ðàíüøå âûïîëíÿåòñÿ; 0 - íå îïåðàòîð.
+	// Âñå îïåðàòîðû ëåâîàññîöèàòèâíû, ñðàâíåíèÿ íå ñöåïëÿþòñÿ (a < b < c - îøèáêà)
+	uint8_t power;
+	BinaryForm form;
+	// Îïåðàöèÿ àòîìà
+	AtomOp op;
+};
+
+// opdec - ïîñëåäíèé ýëåìåíò LexemType
+const size_t LexemTypeCount = static_cast<size_t>(LexemType::opdec) + 1;
+const int MaxBindingPower = 255;
+
+typedef std::array<BinaryOperator, LexemTypeCount> BinaryOperatorTable;
+
+constexpr void binaryOp(BinaryOperatorTable& table, LexemType type, uint8_t power, BinaryForm form, AtomOp op) {
+	table[static_cast<size_t>(type)] = BinaryOperator{ power, form, op };
+}
+
+constexpr BinaryOperatorTable makeBinaryOperators() {
+	BinaryOperatorTable table{};
+
+	binaryOp(table, LexemType::opor, 1, BinaryForm::simple, AtomOp::opor);
+	binaryOp(table, LexemType::opand, 2, BinaryForm::simple, AtomOp::opand);
+	binaryOp(table, LexemType::opeq, 3, BinaryForm::compare, AtomOp::eq);
+	binaryOp(table, LexemType::opne, 3, BinaryForm::compare, AtomOp::ne);
+	binaryOp(table, LexemType::opgt, 3, BinaryForm::compare, AtomOp::gt);
+	binaryOp(table, LexemType::oplt, 3, BinaryForm::compare, AtomOp::lt);
+	binaryOp(table, LexemType::ople, 3, BinaryForm::complexCompare, AtomOp::le);
+	binaryOp(table, LexemType::opplus, 4, BinaryForm::simple, AtomOp::add);
+	binaryOp(table, LexemType::opminus, 4, BinaryForm::simple, AtomOp::sub);
+	binaryOp(table, LexemType::opmult, 5, BinaryForm::function, AtomOp::mul);
+
+	return table;
+}
+
+constexpr BinaryOperatorTable binaryOperators = makeBinaryOperators();
@@ -0,0 +1,62 @@
+#include <cstring>
+
+#include "Interner.h"
+
+
+Interner::Interner() {
+	_names[0].reset(new std::string_view[FirstNames]);
+	_names[0][0] = std::string_view();
+	_size = 1;
+	_index.emplace(std::string_view(), Empty);
+}
+
+
+NameId Interner::intern(std::string_view text) {
+	auto result = _index.find(text);
+	if (result != _index.end())
+		return result->second;
+
+	NameId id = static_cast<NameId>(_size);
+	int block;
+	size_t offset;
+	locate(id, block, offset);
+	if (!_names[block])
+		_names[block].reset(new std::string_view[FirstNames << block]);
+
+	std::string_view stored = store(text);
+	_names[block][offset] = stored;
+	++_size;
+	_index.emplace(stored, id);
+	return id;
+}
+
+
+NameId Interner::find(std::string_view text) const {
+	auto result = _index.find(text);
+	if (result == _index.end())
+		return NotFound;
+	return result->second;
+}
+
+
+std::string_view Interner::store(std::string_view text) {
+	char* place;
+
+	// Äëèííûå èìåíà ïîëó÷àþò ñîáñòâåííûé áëîê, îñòàëüíûå äîïèñûâàþòñÿ â òåêóùèé
+	if (text.size() > BlockSize) {
+		_blocks.emplace_back(new char[text.size()]);
+		place = _blocks.back().get();
+	}
+	else {
+		if (_blockUsed + text.size() > BlockSize) {
+			_blocks.emplace_back(new char[BlockSize]);
+			_block = _blocks.back().get();
+			_blockUsed = 0;
+		}
+		place = _block + _blockUsed;
+		_blockUsed += text.size();
+	}
+
+	std::memcpy(place, text.data(), text.size());
+	return std::string_view(place, text.size());
+}
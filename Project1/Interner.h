@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+typedef uint32_t NameId;
+
+// Òàáëèöà èì¸í: êàæäîå ðàçëè÷íîå èìÿ õðàíèòñÿ îäèí ðàç è ïîëó÷àåò ïëîòíûé 32-áèòíûé íîìåð.
+// Íîìåð 0 çàðåçåðâèðîâàí çà ïóñòûì èìåíåì (âðåìåííûå ïåðåìåííûå).
+// Òåêñòû ëåæàò â áëîêàõ, êîòîðûå íèêîãäà íå ïåðåìåùàþòñÿ, ïîýòîìó âûäàííûå string_view
+// äåéñòâèòåëüíû, ïîêà æèâà òàáëèöà.
+// Ñïèñîê èì¸í ïî íîìåðàì òîæå íå ïåðåìåùàåòñÿ ïðè ðîñòå: â êîíâåéåðíîì ðåæèìå ïîòîê ñêàíåðà
+// äîáàâëÿåò èìåíà, ïîêà òðàíñëÿòîð ÷èòàåò óæå ïîëó÷åííûå ÷åðåç TokenPipe íîìåðà.
+class Interner {
+public:
+	static constexpr NameId Empty = 0;
+	static constexpr NameId NotFound = UINT32_MAX;
+
+	Interner();
+
+	Interner(const Interner&) = delete;
+	Interner& operator = (const Interner&) = delete;
+
+	// Íîìåð èìåíè; íîâîå èìÿ êîïèðóåòñÿ â òàáëèöó
+	NameId intern(std::string_view text);
+	// Íîìåð èìåíè èëè NotFound, åñëè åãî íåò
+	NameId find(std::string_view text) const;
+
+	std::string_view operator [] (NameId id) const {
+		int block;
+		size_t offset;
+		locate(id, block, offset);
+		return _names[block][offset];
+	};
+	size_t size() const { return _size; };
+
+private:
+	std::string_view store(std::string_view text);
+
+	// Áëîê ñïèñêà èì¸í b âìåùàåò FirstNames * 2^b íîìåðîâ
+	static constexpr size_t FirstNames = 1024;
+	static constexpr int MaxNameBlocks = 23;
+	static constexpr size_t BlockSize = 64 * 1024;
+
+	static void locate(NameId id, int& block, size_t& offset) {
+		size_t q = id / FirstNames + 1;
+		block = 0;
+		while (q > 1) {
+			q >>= 1;
+			++block;
+		}
+		offset = id - FirstNames * ((static_cast<size_t>(1) << block) - 1);
+	};
+
+	std::unique_ptr<std::string_view[]> _names[MaxNameBlocks];
+	size_t _size = 0;
+	std::unordered_map<std::string_view, NameId> _index;
+
+	std::vector<std::unique_ptr<char[]>> _blocks;
+	char* _block = nullptr;
+	size_t _blockUsed = BlockSize;
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "Token.h"
+
+// Òàáëèöû êîíå÷íîãî àâòîìàòà ëåêñè÷åñêîãî àíàëèçàòîðà.
+// Ñòðîÿòñÿ íà ýòàïå êîìïèëÿöèè: ñèìâîë -> êëàññ ñèìâîëà, (ñîñòîÿíèå, êëàññ) -> ïåðåõîä.
+
+// Êëàññû ñèìâîëîâ
+enum CharClass : uint8_t {
+	ccOther,		// íåïîääåðæèâàåìûé ñèìâîë
+	ccSpace,		// ' ', '\t', '\n', '\r'
+	ccLetter,		// a-z, A-Z, _
+	ccDigit,		// 0-9
+	ccQuote,		// '
+	ccDQuote,		// "
+	ccMinus,		// -
+	ccExcl,			// !
+	ccLess,			// <
+	ccEqual,		// =
+	ccPlus,			// +
+	ccPipe,			// |
+	ccAmp,			// &
+	ccSingle,		// îäíîñèìâîëüíûå ëåêñåìû: > * [ ] ( ) { } ; , :
+	ccCount
+};
+
+// Äåéñòâèÿ, âûïîëíÿåìûå íà ïåðåõîäå
+enum class LexAction : uint8_t {
+	Skip,			// íè÷åãî íå äåëàòü (ïðîáåë èëè ñìåíà ñîñòîÿíèÿ)
+	StartNumber,	// íà÷àòü íàêîïëåíèå ÷èñëà
+	Number,			// äîáàâèòü öèôðó ê ÷èñëó
+	EndNumber,		// âåðíóòü ñèìâîë è âûäàòü ÷èñëî
+	StartId,		// íà÷àòü èäåíòèôèêàòîð ñ òåêóùåãî ñèìâîëà
+	StartStr,		// íà÷àòü ñòðîêó ñî ñëåäóþùåãî ñèìâîëà
+	Append,			// ïðîäîëæèòü èäåíòèôèêàòîð èëè ñòðîêó
+	EndId,			// âåðíóòü ñèìâîë è âûäàòü èäåíòèôèêàòîð èëè êëþ÷åâîå ñëîâî
+	EndStr,			// âûäàòü ñòðîêó
+	StoreChr,		// çàïîìíèòü ñèìâîë ñèìâîëüíîé êîíñòàíòû
+	EndChr,			// âûäàòü ñèìâîëüíóþ êîíñòàíòó
+	Emit,			// âûäàòü ëåêñåìó arg
+	EmitSingle,		// âûäàòü îäíîñèìâîëüíóþ ëåêñåìó òåêóùåãî ñèìâîëà
+	EmitBack,		// âåðíóòü ñèìâîë è âûäàòü ëåêñåìó arg
+	Error,			// âûäàòü îøèáêó arg
+	Fail			// âûäàòü îøèáêó arg è îñòàíîâèòü àâòîìàò
+};
+
+// Ñîîáùåíèÿ îá îøèáêàõ (arg ó Error è Fail)
+enum LexError : uint8_t {
+	leUnsupported,
+	leEmptyChr,
+	leLongChr,
+	leSinglePipe,
+	leSingleAmp,
+	leNumberOverflow
+};
+
+struct LexTransition {
+	uint8_t next;
+	LexAction action;
+	uint8_t arg;
+};
+
+const int LexStateCount = 13;
+
+typedef std::array<uint8_t, 256> CharClassTable;
+typedef std::array<std::array<LexTransition, ccCount>, LexStateCount> LexTransitionTable;
+
+
+constexpr CharClassTable makeCharClasses() {
+	CharClassTable table{};
+	for (int c = 'a'; c <= 'z'; ++c) table[c] = ccLetter;
+	for (int c = 'A'; c <= 'Z'; ++c) table[c] = ccLetter;
+	for (int c = '0'; c <= '9'; ++c) table[c] = ccDigit;
+	table['_'] = ccLetter;
+	table[' '] = table['\t'] = table['\n'] = table['\r'] = ccSpace;
+	table['\''] = ccQuote;
+	table['"'] = ccDQuote;
+	table['-'] = ccMinus;
+	table['!'] = ccExcl;
+	table['<'] = ccLess;
+	table['='] = ccEqual;
+	table['+'] = ccPlus;
+	table['|'] = ccPipe;
+	table['&'] = ccAmp;
+	for (char c : { '>', '*', '[', ']', '(', ')', '{', '}', ';', ',', ':' })
+		table[static_cast<unsigned char>(c)] = ccSingle;
+	return table;
+}
+
+constexpr std::array<LexemType, 256> makeSingleTokens() {
+	std::array<LexemType, 256> table{};
+	for (auto& item : table) item = LexemType::error;
+	table['>'] = LexemType::opgt;
+	table['*'] = LexemType::opmult;
+	table['['] = LexemType::lbracket;
+	table[']'] = LexemType::rbracket;
+	table['('] = LexemType::lpar;
+	table[')'] = LexemType::rpar;
+	table['{'] = LexemType::lbrace;
+	table['}'] = LexemType::rbrace;
+	table[';'] = LexemType::semicolon;
+	table[','] = LexemType::comma;
+	table[':'] = LexemType::colon;
+	return table;
+}
+
+constexpr LexTransition lexGo(int next, LexAction action = LexAction::Skip, uint8_t arg = 0) {
+	return LexTransition{ static_cast<uint8_t>(next), action, arg };
+}
+
+constexpr uint8_t lexArg(LexemType type) {
+	return static_cast<uint8_t>(type);
+}
+
+// Äâóõñèìâîëüíûé îïåðàòîð: second -> lexem, èíà÷å âåðíóòü ñèìâîë è âûäàòü single
+constexpr void lexPair(LexTransitionTable& table, int state, CharClass second, LexemType lexem, LexemType single) {
+	for (auto& item : table[state]) item = lexGo(0, LexAction::EmitBack, lexArg(single));
+	table[state][second] = lexGo(0, LexAction::Emit, lexArg(lexem));
+}
+
+constexpr LexTransitionTable makeLexTransitions() {
+	LexTransitionTable table{};
+
+	// 0: íà÷àëüíîå ñîñòîÿíèå
+	for (auto& item : table[0]) item = lexGo(0, LexAction::Error, leUnsupported);
+	table[0][ccSpace] = lexGo(0);
+	table[0][ccSingle] = lexGo(0, LexAction::EmitSingle);
+	table[0][ccDigit] = lexGo(1, LexAction::StartNumber);
+	table[0][ccQuote] = lexGo(2);
+	table[0][ccDQuote] = lexGo(4, LexAction::StartStr);
+	table[0][ccLetter] = lexGo(5, LexAction::StartId);
+	table[0][ccMinus] = lexGo(6);
+	table[0][ccExcl] = lexGo(7);
+	table[0][ccLess] = lexGo(8);
+	table[0][ccEqual] = lexGo(9);
+	table[0][ccPlus] = lexGo(10);
+	table[0][ccPipe] = lexGo(11);
+	table[0][ccAmp] = lexGo(12);
+
+	// 1: ÷èñëî
+	for (auto& item : table[1]) item = lexGo(0, LexAction::EndNumber);
+	table[1][ccDigit] = lexGo(1, LexAction::Number);
+
+	// 2, 3: ñèìâîëüíàÿ êîíñòàíòà
+	for (auto& item : table[2]) item = lexGo(3, LexAction::StoreChr);
+	table[2][ccQuote] = lexGo(0, LexAction::Fail, leEmptyChr);
+	for (auto& item : table[3]) item = lexGo(0, LexAction::Fail, leLongChr);
+	table[3][ccQuote] = lexGo(0, LexAction::EndChr);
+
+	// 4: ñòðîêà
+	for (auto& item : table[4]) item = lexGo(4, LexAction::Append);
+	table[4][ccDQuote] = lexGo(0, LexAction::EndStr);
+
+	// 5: êëþ÷åâûå ñëîâà è èìåíà ïåðåìåííûõ è ôóíêöèé
+	for (auto& item : table[5]) item = lexGo(0, LexAction::EndId);
+	table[5][ccLetter] = lexGo(5, LexAction::Append);
+	table[5][ccDigit] = lexGo(5, LexAction::Append);
+
+	// 6 - 10: îïåðàòîðû èç îäíîãî èëè äâóõ ñèìâîëîâ
+	lexPair(table, 6, ccMinus, LexemType::opdec, LexemType::opminus);
+	lexPair(table, 7, ccEqual, LexemType::opne, LexemType::opnot);
+	lexPair(table, 8, ccEqual, LexemType::ople, LexemType::oplt);
+	lexPair(table, 9, ccEqual, LexemType::opeq, LexemType::opassign);
+	lexPair(table, 10, ccPlus, LexemType::opinc, LexemType::opplus);
+
+	// 11, 12: || è &&, îäèíî÷íûå | è & - îøèáêà
+	for (auto& item : table[11]) item = lexGo(0, LexAction::Fail, leSinglePipe);
+	table[11][ccPipe] = lexGo(0, LexAction::Emit, lexArg(LexemType::opor));
+	for (auto& item : table[12]) item = lexGo(0, LexAction::Fail, leSingleAmp);
+	table[12][ccAmp] = lexGo(0, LexAction::Emit, lexArg(LexemType::opand));
+
+	return table;
+}
+
+constexpr CharClassTable charClasses = makeCharClasses();
+constexpr std::array<LexemType, 256> singleTokens = makeSingleTokens();
+constexpr LexTransitionTable lexTransitions = makeLexTransitions();
+
+
+// Ðàñïîçíàâàíèå êëþ÷åâûõ ñëîâ: âûáîð ïî äëèíå è ïåðâîìó ñèìâîëó, çàòåì îäíî ñðàâíåíèå.
+// Íå òðåáóåò ñòàòè÷åñêîé èíèöèàëèçàöèè è íå âûäåëÿåò ïàìÿòü.
+constexpr LexemType keywordType(std::string_view word) {
+	switch (word.size()) {
+		case 2:
+			if (word == "if") return LexemType::kwif;
+			if (word == "in") return LexemType::kwin;
+			break;
+		case 3:
+			if (word[0] == 'i') return word == "int" ? LexemType::kwint : LexemType::id;
+			if (word[0] == 'f') return word == "for" ? LexemType::kwfor : LexemType::id;
+			if (word[0] == 'o') return word == "out" ? LexemType::kwout : LexemType::id;
+			break;
+		case 4:
+			if (word[0] == 'c') {
+				if (word == "char") return LexemType::kwchar;
+				if (word == "case") return LexemType::kwcase;
+			}
+			if (word[0] == 'e') return word == "else" ? LexemType::kwelse : LexemType::id;
+			break;
+		case 5:
+			if (word[0] == 'c') return word == "const" ? LexemType::kwconst : LexemType::id;
+			if (word[0] == 'w') return word == "while" ? LexemType::kwwhile : LexemType::id;
+			break;
+		case 6:
+			if (word[0] == 'r') return word == "return" ? LexemType::kwreturn : LexemType::id;
+			if (word[0] == 's') return word == "switch" ? LexemType::kwswitch : LexemType::id;
+			break;
+		case 7:
+			if (word[0] == 'd') return word == "default" ? LexemType::kwdefault : LexemType::id;
+			break;
+	}
+	return LexemType::id;
+}
+
+static_assert(keywordType("return") == LexemType::kwreturn && keywordType("int") == LexemType::kwint &&
+			  keywordType("char") == LexemType::kwchar && keywordType("const") == LexemType::kwconst &&
+			  keywordType("if") == LexemType::kwif && keywordType("else") == LexemType::kwelse &&
+			  keywordType("switch") == LexemType::kwswitch && keywordType("case") == LexemType::kwcase &&
+			  keywordType("default") == LexemType::kwdefault && keywordType("while") == LexemType::kwwhile &&
+			  keywordType("for") == LexemType::kwfor && keywordType("in") == LexemType::kwin &&
+			  keywordType("out") == LexemType::kwout, "keywordType: íåâåðíîå êëþ÷åâîå ñëîâî");
+static_assert(keywordType("i") == LexemType::id && keywordType("ints") == LexemType::id &&
+			  keywordType("cas") == LexemType::id && keywordType("chars") == LexemType::id &&
+			  keywordType("Int") == LexemType::id && keywordType("main") == LexemType::id, "keywordType: èäåíòèôèêàòîð ïðèíÿò çà êëþ÷åâîå ñëîâî");
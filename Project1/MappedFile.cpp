@@ -0,0 +1,93 @@
+#include <exception>
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw std::exception(("Íå óäàëîñü îòêðûòü ôàéë " + path).c_str());
+	}
+	_file = file;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)) {
+		CloseHandle(file);
+		throw std::exception(("Íå óäàëîñü óçíàòü ðàçìåð ôàéëà " + path).c_str());
+	}
+
+	// Ïóñòîé ôàéë îòîáðàçèòü íåëüçÿ - îñòàâëÿåì ïóñòîé áóôåð
+	if (size.QuadPart == 0)
+		return;
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		CloseHandle(file);
+		throw std::exception(("Íå óäàëîñü îòîáðàçèòü ôàéë " + path).c_str());
+	}
+	_mapping = mapping;
+
+	_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (_data == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		throw std::exception(("Íå óäàëîñü îòîáðàçèòü ôàéë " + path).c_str());
+	}
+	_size = static_cast<size_t>(size.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+	if (_size != 0)
+		UnmapViewOfFile(_data);
+	if (_mapping != nullptr)
+		CloseHandle(_mapping);
+	if (_file != nullptr)
+		CloseHandle(_file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw std::exception(("Íå óäàëîñü îòêðûòü ôàéë " + path).c_str());
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		throw std::exception(("Íå óäàëîñü óçíàòü ðàçìåð ôàéëà " + path).c_str());
+	}
+
+	// Ïóñòîé ôàéë îòîáðàçèòü íåëüçÿ - îñòàâëÿåì ïóñòîé áóôåð
+	if (st.st_size != 0) {
+		void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			close(fd);
+			throw std::exception(("Íå óäàëîñü îòîáðàçèòü ôàéë " + path).c_str());
+		}
+		madvise(data, st.st_size, MADV_SEQUENTIAL);
+		_data = static_cast<const char*>(data);
+		_size = static_cast<size_t>(st.st_size);
+	}
+	close(fd);
+}
+
+MappedFile::~MappedFile() {
+	if (_size != 0)
+		munmap(const_cast<char*>(_data), _size);
+}
+
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+// Ôàéë èñõîäíîãî òåêñòà, öåëèêîì îòîáðàæ¸ííûé â ïàìÿòü (òîëüêî äëÿ ÷òåíèÿ).
+// Èñïîëüçóåòñÿ äëÿ ðåæèìà áóôåðà â Scanner.
+class MappedFile {
+public:
+	MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator = (const MappedFile&) = delete;
+
+	const char* begin() const { return _data; };
+	const char* end() const { return _data + _size; };
+	size_t size() const { return _size; };
+
+private:
+	const char* _data = "";
+	size_t _size = 0;
+
+#ifdef _WIN32
+	void* _file = nullptr;
+	void* _mapping = nullptr;
+#endif
+};
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "ParallelLexer.h"
+#include "ScanKernels.h"
+#include "Scanner.h"
+
+
+std::vector<const char*> findLexSplits(const char* begin, const char* end, size_t chunks) {
+	std::vector<const char*> splits{ begin };
+	size_t target = (end - begin) / (chunks == 0 ? 1 : chunks);
+	int depth = 0;
+	const ScanKernels& kernels = scanKernels();
+
+	// Ïîâòîðÿåì òî, êàê ñêàíåð ïðîõîäèò ëèòåðàëû: } âíóòðè ñòðîêè èëè ñèìâîëüíîé êîíñòàíòû
+	// íå ãðàíèöà. Ðàçáîð, êîòîðûé ñêàíåð ïðåðâ¸ò îøèáêîé, äàëüøå äåëèòü íåçà÷åì
+	const char* p = begin;
+	while (splits.size() < chunks) {
+		p = kernels.structure(p, end);
+		if (p == end)
+			break;
+
+		char c = *p++;
+		if (c == '"') {
+			p = kernels.string(p, end);
+			if (p == end)
+				break;
+			++p;
+		}
+		else if (c == '\'') {
+			if (end - p < 2 or p[0] == '\'' or p[1] != '\'')
+				break;
+			p += 2;
+		}
+		else if (c == '{')
+			++depth;
+		else if (c == '}' and --depth <= 0) {
+			depth = 0;
+			if (static_cast<size_t>(p - splits.back()) >= target and p != end)
+				splits.push_back(p);
+		}
+	}
+
+	splits.push_back(end);
+	return splits;
+}
+
+
+void lexParallel(const char* begin, const char* end, Interner& names, TokenBuffer& tokens, unsigned threads) {
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	size_t chunks = std::min<size_t>(threads, (end - begin) / MinLexChunkSize);
+
+	// Ìàëåíüêèé âõîä èëè îäíî ÿäðî - îáû÷íûé ðàçáîð
+	if (chunks <= 1) {
+		Scanner scanner(begin, end, &names);
+		tokens.fill(scanner);
+		return;
+	}
+
+	std::vector<const char*> splits = findLexSplits(begin, end, chunks);
+	chunks = splits.size() - 1;
+
+	struct Chunk {
+		Interner names;
+		std::unique_ptr<TokenBuffer> tokens;
+		bool failed = false;
+	};
+	std::vector<Chunk> parts(chunks);
+
+	auto lexChunk = [&](size_t index) {
+		Chunk& part = parts[index];
+		Scanner scanner(splits[index], splits[index + 1], &part.names);
+		part.tokens.reset(new TokenBuffer(part.names));
+		part.tokens->fill(scanner);
+		part.failed = scanner.failed();
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t i = 1; i < chunks; ++i)
+		workers.emplace_back(lexChunk, i);
+	lexChunk(0);
+	for (auto& worker : workers)
+		worker.join();
+
+	// Ñêëåéêà â ïîðÿäêå òåêñòà. Íîìåðà èì¸í â îáùåé òàáëèöå âûäàþòñÿ â òîì æå ïîðÿäêå,
+	// ÷òî è ïðè ïîñëåäîâàòåëüíîì ðàçáîðå: êóñîê çà êóñêîì, âíóòðè êóñêà - ïî ïåðâîìó ïîÿâëåíèþ.
+	// Ïîñëå îøèáêè, ïðåðâàâøåé ðàçáîð, ïîñëåäîâàòåëüíûé ñêàíåð äàëüøå íå ÷èòàåò
+	size_t total = 0;
+	for (auto& part : parts)
+		total += part.tokens->size();
+	tokens.reserve(total);
+
+	for (size_t i = 0; i < chunks; ++i) {
+		Chunk& part = parts[i];
+		std::vector<NameId> remap(part.names.size());
+		for (NameId id = 1; id < remap.size(); ++id)
+			remap[id] = names.intern(part.names[id]);
+
+		bool last = part.failed or i + 1 == chunks;
+		tokens.append(*part.tokens, remap, splits[i] - begin, last);
+		if (last)
+			break;
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+
+#include "Interner.h"
+#include "TokenBuffer.h"
+
+// Ïàðàëëåëüíûé ðàçáîð èñõîäíîãî òåêñòà íà ëåêñåìû.
+// Òåêñò äåëèòñÿ íà êóñêè ïîñëå çàêðûâàþùèõ } âåðõíåãî óðîâíÿ, êàæäûé êóñîê ðàçáèðàåòñÿ
+// ñâîèì ñêàíåðîì ñî ñâîåé òàáëèöåé èì¸í, çàòåì áóôåðû ñêëåèâàþòñÿ â ïîðÿäêå òåêñòà,
+// à íîìåðà èì¸í ïåðåâîäÿòñÿ â îáùóþ òàáëèöó â ïîðÿäêå ïåðâîãî ïîÿâëåíèÿ.
+// Ðåçóëüòàò ñîâïàäàåò ñ ïîñëåäîâàòåëüíûì ðàçáîðîì Scanner ëåêñåìà â ëåêñåìó.
+
+// Êóñîê ìåíüøå ýòîãî ðàçìåðà íå ñòîèò îòäåëüíîãî ïîòîêà
+const size_t MinLexChunkSize = 256 * 1024;
+
+// Òî÷êè ðàçáèåíèÿ [begin, end) íå áîëåå ÷åì íà chunks êóñêîâ ïðèìåðíî ðàâíîãî ðàçìåðà.
+// Âîçâðàùàåò ãðàíèöû êóñêîâ: ïåðâàÿ - begin, ïîñëåäíÿÿ - end
+std::vector<const char*> findLexSplits(const char* begin, const char* end, size_t chunks);
+
+// Ðàçîáðàòü [begin, end) íà threads ïîòîêàõ (0 - ïî ÷èñëó ÿäåð) â tokens, èìåíà - â names
+void lexParallel(const char* begin, const char* end, Interner& names, TokenBuffer& tokens, unsigned threads = 0);
@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Translator.h"
+
+// Äâóõôàçíûé ïàðàëëåëüíûé ðàçáîð (Translator::translateParallel).
+// 1. Ïî óæå ãîòîâûì ëåêñåìàì äåëèòñÿ âåðõíèé óðîâåíü ïðîãðàììû: îáúÿâëåíèÿ ãëîáàëüíûõ ïåðåìåííûõ
+//    ðàçáèðàþòñÿ ñðàçó, ó ôóíêöèé çàïîìèíàþòñÿ èìÿ, òèï, ÷èñëî ïàðàìåòðîâ è ãðàíèöû.
+// 2. Êàæäàÿ ôóíêöèÿ ðàçáèðàåòñÿ íà ïîòîêå ñâîèì Translator ïðÿìî ïî ëåêñåìàì è ñ òàáëèöåé èì¸í
+//    ãëàâíîãî òðàíñëÿòîðà: íà ýòîé ôàçå èõ íèêòî íå ìåíÿåò. Äðóã î äðóãå ôóíêöèè çíàþò òîëüêî òî,
+//    ÷òî îáúÿâëåíî âûøå íèõ, ïîýòîìó ðàáî÷åìó çàðàíåå çàíîñÿòñÿ ãëîáàëüíûå ïåðåìåííûå è ôóíêöèè,
+//    êîòîðûå âûøå è èìåíà êîòîðûõ âñòðå÷àþòñÿ â åãî òåêñòå.
+// 3. Ðåçóëüòàòû ñëèâàþòñÿ â ïîðÿäêå òåêñòà: çàïèñè, ñòðîêè è ìåòêè ïîëó÷àþò òå æå íîìåðà,
+//    ÷òî äàë áû ïîñëåäîâàòåëüíûé ðàçáîð, è âûâîä ñîâïàäàåò áàéò â áàéò.
+//    Ñòðîêè âñå ðàáî÷èå ñðàçó êëàäóò â îáùèé ConcurrentInterner ñ êëþ÷îì (íîìåð îáúÿâëåíèÿ, íîìåð âõîæäåíèÿ),
+//    ïî êîòîðîìó îíè ïîòîì íóìåðóþòñÿ â ïîðÿäêå ïåðâîãî ïîÿâëåíèÿ.
+// Åñëè ïðîãðàììà íå óêëàäûâàåòñÿ â ýòó ñõåìó èëè â êàêîé-òî ôóíêöèè îøèáêà, îíà ðàçáèðàåòñÿ
+// ïîñëåäîâàòåëüíî - ñîîáùåíèå îá îøèáêå îñòà¸òñÿ ïðåæíèì.
+
+typedef SymbolTable::TableRecord TSrec;
+
+// Îáúÿâëåíèå âåðõíåãî óðîâíÿ: ãëîáàëüíàÿ ïåðåìåííàÿ èëè ôóíêöèÿ
+struct Translator::TopLevelItem {
+	TSrec::RecordKind kind;
+	TSrec::RecordType type;
+	NameId name;
+	// Íà÷àëüíîå çíà÷åíèå ïåðåìåííîé èëè ÷èñëî ïàðàìåòðîâ ôóíêöèè
+	int value;
+	// Ëåêñåìû ôóíêöèè [first, last)
+	size_t first;
+	size_t last;
+};
+
+// Ôóíêöèÿ, ðàçîáðàííàÿ îòäåëüíî
+struct Translator::FunctionUnit {
+	std::unique_ptr<Translator> translator;
+	// Íîìåðà îáúÿâëåíèé, çàíåñ¸ííûõ ðàáî÷åìó äî ðàçáîðà, â ïîðÿäêå åãî çàïèñåé
+	std::vector<size_t> preload;
+	bool failed = false;
+};
+
+
+bool Translator::splitTopLevel(std::vector<TopLevelItem>& items, std::unordered_map<NameId, size_t>& declared) const {
+	auto type = [this](size_t i) {
+		return i < _tokens.size() ? _tokens.type(i) : LexemType::eof;
+	};
+	auto value = [this](size_t i) {
+		return _tokens[i].value();
+	};
+	// Ïîâòîðíàÿ ãëîáàëüíàÿ ïåðåìåííàÿ ìîë÷à ïðîïóñêàåòñÿ, êàê â SymbolTable::addVar
+	auto addVar = [&](TSrec::RecordType recordType, NameId name, int init) {
+		if (declared.emplace(name, items.size()).second)
+			items.push_back({ TSrec::RecordKind::var, recordType, name, init, 0, 0 });
+	};
+
+	size_t i = 0;
+	while (type(i) != LexemType::eof) {
+		if ((type(i) != LexemType::kwint and type(i) != LexemType::kwchar) or type(i + 1) != LexemType::id)
+			return false;
+		auto recordType = type(i) == LexemType::kwint ? TSrec::RecordType::integer : TSrec::RecordType::chr;
+		NameId name = value(i + 1);
+
+		if (type(i + 2) == LexemType::lpar) {
+			// type id ( ïàðàìåòðû ) { òåëî }
+			size_t j = i + 3;
+			int params = type(j) == LexemType::rpar ? 0 : 1;
+			for (; type(j) != LexemType::rpar; ++j) {
+				if (type(j) == LexemType::eof or type(j) == LexemType::lbrace or type(j) == LexemType::semicolon)
+					return false;
+				if (type(j) == LexemType::comma)
+					++params;
+			}
+			++j;
+			if (type(j) != LexemType::lbrace)
+				return false;
+
+			int depth = 0;
+			do {
+				if (type(j) == LexemType::eof)
+					return false;
+				if (type(j) == LexemType::lbrace)
+					++depth;
+				else if (type(j) == LexemType::rbrace)
+					--depth;
+				++j;
+			} while (depth > 0);
+
+			// Èìÿ ôóíêöèè óæå çàíÿòî - ýòî îøèáêà ðàçáîðà
+			if (!declared.emplace(name, items.size()).second)
+				return false;
+			items.push_back({ TSrec::RecordKind::func, recordType, name, params, i, j });
+			i = j;
+		}
+		else {
+			// type id [= ÷èñëî] {, id [÷èñëî]} ;
+			size_t j = i + 2;
+			int init = 0;
+			if (type(j) == LexemType::opassign) {
+				if (type(j + 1) != LexemType::num and type(j + 1) != LexemType::chr)
+					return false;
+				init = value(j + 1);
+				j += 2;
+			}
+			addVar(recordType, name, init);
+
+			while (type(j) == LexemType::comma) {
+				if (type(j + 1) != LexemType::id)
+					return false;
+				name = value(j + 1);
+				init = 0;
+				j += 2;
+				if (type(j) == LexemType::num or type(j) == LexemType::chr) {
+					init = value(j);
+					++j;
+				}
+				addVar(recordType, name, init);
+			}
+
+			if (type(j) != LexemType::semicolon)
+				return false;
+			i = j + 1;
+		}
+	}
+	return true;
+}
+
+
+Translator::Translator(const Translator& parent, size_t first, size_t last)
+	: _names{ parent._names }, _sourceSize{ parent._tokens.offset(last - 1) - parent._tokens.offset(first) + 1 }, _symbolTable{ _names },
+	  _scanner{ nullptr, nullptr }, _lexMode{ LexMode::batch }, _tokens{ _names }, _tokenSource{ &parent._tokens },
+	  _tokenIndex{ first }, _tokenEnd{ last }, _currentLabel{ 1 } {
+	nextToken();
+}
+
+
+void Translator::parseFunction(FunctionUnit& unit, const std::vector<TopLevelItem>& items,
+							   const std::unordered_map<NameId, size_t>& declared, size_t index, ConcurrentInterner& strings) const {
+	const TopLevelItem& item = items[index];
+
+	// Îáúÿâëåíèÿ âûøå ôóíêöèè, íà êîòîðûå îíà ìîæåò ñîñëàòüñÿ
+	for (size_t i = item.first; i < item.last; ++i) {
+		if (_tokens.type(i) != LexemType::id)
+			continue;
+		auto found = declared.find(_tokens[i].value());
+		if (found != declared.end() and found->second < index)
+			unit.preload.push_back(found->second);
+	}
+	std::sort(unit.preload.begin(), unit.preload.end());
+	unit.preload.erase(std::unique(unit.preload.begin(), unit.preload.end()), unit.preload.end());
+
+	try {
+		unit.translator.reset(new Translator(*this, item.first, item.last));
+		Translator& worker = *unit.translator;
+
+		for (size_t i : unit.preload) {
+			const TopLevelItem& other = items[i];
+			if (other.kind == TSrec::RecordKind::var) {
+				worker._symbolTable.addRecord(TSrec(other.name, other.kind, other.type, GlobalScope), other.value);
+			}
+			else {
+				TSrec record(other.name, other.kind, other.type, GlobalScope);
+				record._len = static_cast<int16_t>(other.value);
+				worker._symbolTable.addRecord(record);
+				worker._atoms.emplace_back();
+			}
+		}
+
+		worker._sharedStrings = &strings;
+		worker._stringOrder = static_cast<uint64_t>(index) << 32;
+		worker.StmtList(GlobalScope);
+		unit.failed = worker._currentToken.type() != LexemType::eof;
+	}
+	catch (...) {
+		unit.failed = true;
+	}
+}
+
+
+bool Translator::canMerge(const std::vector<TopLevelItem>& items, const std::vector<FunctionUnit>& units) const {
+	// Ôóíêöèþ íåëüçÿ íàçâàòü òàê æå, êàê ïåðåìåííóþ ëþáîé ôóíêöèè âûøå (SymbolTable::addFunc);
+	// ðàáî÷èé ýòèõ ïåðåìåííûõ íå âèäåë
+	std::unordered_set<NameId> localNames;
+	size_t unit = 0;
+	for (auto& item : items) {
+		if (item.kind != TSrec::RecordKind::func)
+			continue;
+		auto& current = units[unit++];
+		if (current.failed or localNames.count(item.name))
+			return false;
+
+		const Translator& worker = *current.translator;
+		for (auto& record : worker._symbolTable.locals(static_cast<Scope>(current.preload.size()))) {
+			if (record._name != Interner::Empty)
+				localNames.insert(record._name);
+		}
+	}
+	return true;
+}
+
+
+void Translator::mergeFunctions(const std::vector<TopLevelItem>& items, std::vector<FunctionUnit>& units, const ConcurrentInterner& strings) {
+	// Íîìåð çàïèñè êàæäîãî îáúÿâëåíèÿ â îáùåé òàáëèöå
+	std::vector<int> recordOf(items.size(), -1);
+	size_t unit = 0;
+
+	// Íîìåð â òàáëèöå ñòðîê äëÿ êàæäîãî íîìåðà îáùåé òàáëèöû: ñòðîêè çàíîñÿòñÿ â ïîðÿäêå ïåðâîãî ïîÿâëåíèÿ
+	std::vector<uint32_t> renumbered = strings.renumber();
+	std::vector<uint32_t> byOrder(strings.size());
+	for (uint32_t id = 0; id < renumbered.size(); ++id) {
+		if (renumbered[id] != ConcurrentInterner::NotFound)
+			byOrder[renumbered[id]] = id;
+	}
+	std::vector<int> stringOf(renumbered.size(), -1);
+	for (uint32_t id : byOrder)
+		stringOf[id] = _stringTable.add(strings[id]).value();
+
+	for (size_t k = 0; k < items.size(); ++k) {
+		const TopLevelItem& item = items[k];
+		if (item.kind == TSrec::RecordKind::var) {
+			recordOf[k] = _symbolTable.addRecord(TSrec(item.name, item.kind, item.type, GlobalScope), item.value).value();
+			continue;
+		}
+
+		FunctionUnit& current = units[unit++];
+		Translator& worker = *current.translator;
+		const int preloaded = static_cast<int>(current.preload.size());
+		const int base = static_cast<int>(_symbolTable._records.size());
+		recordOf[k] = base;
+
+		// Çàïèñè ñàìîé ôóíêöèè: îíà, ïàðàìåòðû, ëîêàëüíûå è âðåìåííûå ïåðåìåííûå
+		for (size_t i = preloaded; i < worker._symbolTable._records.size(); ++i) {
+			TSrec record = worker._symbolTable._records[i];
+			if (record._scope != GlobalScope)
+				record._scope = base;
+			_symbolTable.addRecord(record, worker._symbolTable.init(i));
+		}
+
+		const int labelBase = _currentLabel - 1;
+
+		auto remap = [&](Operand operand) {
+			switch (operand.kind()) {
+			case OperandKind::memory:
+				if (operand.value() < preloaded)
+					return Operand::memory(recordOf[current.preload[operand.value()]]);
+				return Operand::memory(base + operand.value() - preloaded);
+			case OperandKind::string:
+				return Operand::string(stringOf[operand.value()]);
+			case OperandKind::label:
+				return Operand::label(labelBase + operand.value());
+			default:
+				return operand;
+			}
+		};
+
+		auto& atoms = worker._atoms[worker._symbolTable[preloaded]._ordinal];
+		for (auto& atom : atoms) {
+			atom.first = remap(atom.first);
+			atom.second = remap(atom.second);
+			atom.result = remap(atom.result);
+		}
+		_atomCount += atoms.size();
+		_atoms.push_back(std::move(atoms));
+		_currentLabel += worker._currentLabel - 1;
+
+		current.translator.reset();
+	}
+}
+
+
+bool Translator::translateParallel(unsigned threads) {
+	std::vector<TopLevelItem> items;
+	std::unordered_map<NameId, size_t> declared;
+	if ((_lexMode != LexMode::batch and _lexMode != LexMode::parallel) or !splitTopLevel(items, declared))
+		return translate();
+
+	std::vector<size_t> functions;
+	for (size_t i = 0; i < items.size(); ++i) {
+		if (items[i].kind == TSrec::RecordKind::func)
+			functions.push_back(i);
+	}
+	if (functions.size() < 2)
+		return translate();
+
+	// Ôóíêöèè ðàçäàþòñÿ ïîòîêàì ïî îäíîé: èõ ðàçìåðû ñèëüíî ðàçëè÷àþòñÿ
+	std::vector<FunctionUnit> units(functions.size());
+	ConcurrentInterner strings;
+	std::atomic<size_t> next{ 0 };
+	auto work = [&]() {
+		for (size_t k = next++; k < functions.size(); k = next++)
+			parseFunction(units[k], items, declared, functions[k], strings);
+	};
+
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = static_cast<unsigned>(std::min<size_t>(threads, functions.size()));
+	std::vector<std::thread> pool;
+	for (unsigned t = 1; t < threads; ++t)
+		pool.emplace_back(work);
+	work();
+	for (auto& thread : pool)
+		thread.join();
+
+	if (!canMerge(items, units))
+		return translate();
+
+	mergeFunctions(items, units, strings);
+	_symbolTable.calculateOffset();
+	return true;
+}
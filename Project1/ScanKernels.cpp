@@ -0,0 +1,194 @@
+#include "ScanKernels.h"
+#include "LexerTables.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SCAN_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC ïîçâîëÿåò èñïîëüçîâàòü ëþáûå intrinsic-ôóíêöèè áåç ôëàãîâ êîìïèëÿöèè,
+// GCC è Clang òðåáóþò ïîìåòèòü ôóíêöèþ öåëåâûì íàáîðîì èíñòðóêöèé
+#if defined(SCAN_KERNELS_X86) && !defined(_MSC_VER)
+#define SCAN_AVX2 __attribute__((target("avx2")))
+#else
+#define SCAN_AVX2
+#endif
+
+
+// Êëàññû ñåðèé: ïðîâåðêà îäíîãî ñèìâîëà è ìàñêè áëîêîâ
+struct SpaceRun {
+	static bool is(char c) { return charClasses[static_cast<unsigned char>(c)] == ccSpace; };
+#ifdef SCAN_KERNELS_X86
+	static __m128i match(__m128i v) {
+		return _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+							_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+	};
+	SCAN_AVX2 static __m256i match(__m256i v) {
+		return _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+							   _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+	};
+#endif
+};
+
+// Äèàïàçîí [lo, hi] ïðîâåðÿåòñÿ îäíèì çíàêîâûì ñðàâíåíèåì: ñèìâîë ñäâèãàåòñÿ òàê,
+// ÷òîáû lo ïîïàë â -128, òîãäà âñ¸, ÷òî âíå äèàïàçîíà, îêàçûâàåòñÿ íå ìåíüøå -128 + äëèíà
+struct DigitRun {
+	static bool is(char c) { return charClasses[static_cast<unsigned char>(c)] == ccDigit; };
+#ifdef SCAN_KERNELS_X86
+	static __m128i match(__m128i v) {
+		return _mm_cmplt_epi8(_mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - '0'))), _mm_set1_epi8(static_cast<char>(0x80 + 10)));
+	};
+	SCAN_AVX2 static __m256i match(__m256i v) {
+		return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + 10)), _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - '0'))));
+	};
+#endif
+};
+
+// Áóêâû ïðîâåðÿþòñÿ ïîñëå ïðèâåäåíèÿ ê íèæíåìó ðåãèñòðó: c | 0x20 ïîïàäàåò â a-z òîëüêî ó áóêâ
+struct IdentifierRun {
+	static bool is(char c) {
+		uint8_t cc = charClasses[static_cast<unsigned char>(c)];
+		return cc == ccLetter or cc == ccDigit;
+	};
+#ifdef SCAN_KERNELS_X86
+	static __m128i match(__m128i v) {
+		__m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+		__m128i letter = _mm_cmplt_epi8(_mm_add_epi8(lower, _mm_set1_epi8(static_cast<char>(0x80 - 'a'))), _mm_set1_epi8(static_cast<char>(0x80 + 26)));
+		return _mm_or_si128(_mm_or_si128(letter, DigitRun::match(v)), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+	};
+	SCAN_AVX2 static __m256i match(__m256i v) {
+		__m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+		__m256i letter = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + 26)), _mm256_add_epi8(lower, _mm256_set1_epi8(static_cast<char>(0x80 - 'a'))));
+		return _mm256_or_si256(_mm256_or_si256(letter, DigitRun::match(v)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+	};
+#endif
+};
+
+// Òåëî ñòðîêè - âñ¸, êðîìå êàâû÷êè
+struct StringRun {
+	static bool is(char c) { return c != '"'; };
+#ifdef SCAN_KERNELS_X86
+	static __m128i match(__m128i v) {
+		return _mm_xor_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_set1_epi8(-1));
+	};
+	SCAN_AVX2 static __m256i match(__m256i v) {
+		return _mm256_xor_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), _mm256_set1_epi8(-1));
+	};
+#endif
+};
+
+// Âñ¸, êðîìå ", ', { è }
+struct StructureRun {
+	static bool is(char c) { return c != '"' and c != '\'' and c != '{' and c != '}'; };
+#ifdef SCAN_KERNELS_X86
+	static __m128i match(__m128i v) {
+		__m128i quotes = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\'')));
+		__m128i braces = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('{')), _mm_cmpeq_epi8(v, _mm_set1_epi8('}')));
+		return _mm_xor_si128(_mm_or_si128(quotes, braces), _mm_set1_epi8(-1));
+	};
+	SCAN_AVX2 static __m256i match(__m256i v) {
+		__m256i quotes = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\'')));
+		__m256i braces = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('}')));
+		return _mm256_xor_si256(_mm256_or_si256(quotes, braces), _mm256_set1_epi8(-1));
+	};
+#endif
+};
+
+
+template <class Run>
+static const char* scalarRun(const char* begin, const char* end) {
+	while (begin != end and Run::is(*begin))
+		++begin;
+	return begin;
+}
+
+#ifdef SCAN_KERNELS_X86
+
+// Íîìåð ìëàäøåãî óñòàíîâëåííîãî áèòà, mask != 0
+static unsigned lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+template <class Run>
+static const char* sse2Run(const char* begin, const char* end) {
+	while (end - begin >= 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+		uint32_t stop = ~static_cast<uint32_t>(_mm_movemask_epi8(Run::match(block))) & 0xFFFF;
+		if (stop != 0)
+			return begin + lowestBit(stop);
+		begin += 16;
+	}
+	return scalarRun<Run>(begin, end);
+}
+
+template <class Run>
+SCAN_AVX2 static const char* avx2Run(const char* begin, const char* end) {
+	while (end - begin >= 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+		uint32_t stop = ~static_cast<uint32_t>(_mm256_movemask_epi8(Run::match(block)));
+		if (stop != 0)
+			return begin + lowestBit(stop);
+		begin += 32;
+	}
+	return sse2Run<Run>(begin, end);
+}
+
+
+static bool hasAvx2() {
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	// AVX2 äîëæåí ïîääåðæèâàòü è ïðîöåññîð, è ÎÑ (ñîõðàíåíèå ðåãèñòðîâ ymm)
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave or !avx or (_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+
+static const ScanKernels scalarKernels = {
+	scalarRun<SpaceRun>, scalarRun<IdentifierRun>, scalarRun<DigitRun>, scalarRun<StringRun>, scalarRun<StructureRun>, "scalar"
+};
+
+#ifdef SCAN_KERNELS_X86
+static const ScanKernels sse2Kernels = {
+	sse2Run<SpaceRun>, sse2Run<IdentifierRun>, sse2Run<DigitRun>, sse2Run<StringRun>, sse2Run<StructureRun>, "sse2"
+};
+
+static const ScanKernels avx2Kernels = {
+	avx2Run<SpaceRun>, avx2Run<IdentifierRun>, avx2Run<DigitRun>, avx2Run<StringRun>, avx2Run<StructureRun>, "avx2"
+};
+#endif
+
+
+const ScanKernels& scanKernels() {
+#ifdef SCAN_KERNELS_X86
+	static const ScanKernels& best = hasAvx2() ? avx2Kernels : sse2Kernels;
+	return best;
+#else
+	return scalarKernels;
+#endif
+}
+
+const ScanKernels& scalarScanKernels() {
+	return scalarKernels;
+}
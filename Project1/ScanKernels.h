@@ -0,0 +1,26 @@
+#pragma once
+
+// Ïîèñê êîíöà ñåðèè îäíîòèïíûõ ñèìâîëîâ â áóôåðå èñõîäíîãî òåêñòà.
+// Êàæäàÿ ôóíêöèÿ âîçâðàùàåò óêàçàòåëü íà ïåðâûé ñèìâîë èç [begin, end), íå âõîäÿùèé â ñåðèþ, èëè end.
+// Âåêòîðíûå âàðèàíòû ïðîâåðÿþò ïî 16 (SSE2) èëè 32 (AVX2) áàéòà çà ðàç.
+struct ScanKernels {
+	typedef const char* (*Kernel)(const char* begin, const char* end);
+
+	// Ïðîáåëüíûå ñèìâîëû (ñîñòîÿíèå 0)
+	Kernel spaces;
+	// Áóêâû, öèôðû è _ (ñîñòîÿíèå 5)
+	Kernel identifier;
+	// Öèôðû (ñîñòîÿíèå 1)
+	Kernel digits;
+	// Òåëî ñòðîêè äî çàêðûâàþùåé " (ñîñòîÿíèå 4)
+	Kernel string;
+	// Âñ¸, êðîìå êàâû÷åê è ôèãóðíûõ ñêîáîê (ïîèñê ãðàíèö ôóíêöèé â ParallelLexer)
+	Kernel structure;
+
+	const char* name;
+};
+
+// Íàáîð ÿäåð, ëó÷øèé äëÿ òåêóùåãî ïðîöåññîðà. Âûáèðàåòñÿ ïðè ïåðâîì âûçîâå
+const ScanKernels& scanKernels();
+// Ñêàëÿðíûé íàáîð, ðàáîòàåò âåçäå
+const ScanKernels& scalarScanKernels();
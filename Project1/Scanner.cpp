@@ -1,14 +1,98 @@
+#include <climits>
+#include <cstring>
+
 #include "Scanner.h"
+#include "LexerTables.h"
+#include "ScanKernels.h"
+
+
+// Ñîîáùåíèÿ îá îøèáêàõ â ïîðÿäêå LexError
+static const char* const lexErrors[] = {
+	"Íåïîääåðæèâàåìûé ÿçûêîì ñèìâîë",
+	"Ïóñòàÿ ñèìâîëüíàÿ êîíñòàíòà",
+	"Ñèìâîëüíàÿ êîíñòàíòà, ñîäåðæàùàÿ áîëåå îäíîãî ñèìâîëà",
+	"Îäèíî÷íûé ñèìâîë |",
+	"Îäèíî÷íûé ñèìâîë &",
+	"×èñëî íå ïîìåùàåòñÿ â int"
+};
+
+
+// Äîïèñàòü öèôðó ê ÷èñëó; false, åñëè ðåçóëüòàò íå ïîìåùàåòñÿ â int (÷èñëî òîãäà íå ìåíÿåòñÿ)
+static bool appendDigit(int& number, char c) {
+	int digit = c - '0';
+	if (number > (INT_MAX - digit) / 10)
+		return false;
+	number = number * 10 + digit;
+	return true;
+}
 
-bool is_Letter(char& c) {
-	if ((c >= 'a') && (c <= 'z'))
-		return true;
-	if ((c >= 'A') && (c <= 'Z'))
-		return true;
-	if (c == '_')
-		return true;
+bool Scanner::nextChar(char& c) {
+	if (_cur == _end and !refill())
+		return false;
+	c = *_cur++;
+	return true;
+}
 
-	return false;
+void Scanner::returnChar() {
+	// Ñèìâîë âñåãäà åù¸ â îêíå: ïîäêà÷êà áûâàåò òîëüêî ïåðåä âçÿòèåì ñëåäóþùåãî.
+	// Ïîñëå êîíöà âõîäà âîçâðàùàòü íå÷åãî - íà í¸ì áûë ïîäñòàâëåí ïðîáåë
+	if (!is_stopped)
+		--_cur;
+}
+
+bool Scanner::refill() {
+	if (input_stream == nullptr)
+		return false;
+
+	// Íà÷àòûå èäåíòèôèêàòîð èëè ñòðîêó ïåðåíîñèì â íà÷àëî îêíà, îñòàëüíîå óæå íå íóæíî.
+	// Åñëè ëåêñåìà çàíÿëà âñ¸ îêíî, òî îêíî ïðèõîäèòñÿ óâåëè÷èòü
+	size_t kept = 0;
+	const char* keptStart = _end;
+	if (State == 4 or State == 5) {
+		keptStart = _lexemeStart;
+		kept = _end - _lexemeStart;
+	}
+	_windowOffset += (keptStart - _begin);
+
+	if (kept == _windowSize) {
+		std::unique_ptr<char[]> larger(new char[_windowSize * 2]);
+		std::memcpy(larger.get(), keptStart, kept);
+		_window = std::move(larger);
+		_windowSize *= 2;
+	}
+	else if (kept != 0)
+		std::memmove(_window.get(), keptStart, kept);
+
+	input_stream->read(_window.get() + kept, _windowSize - kept);
+	size_t count = static_cast<size_t>(input_stream->gcount());
+
+	_begin = _window.get();
+	_lexemeStart = _begin;
+	_cur = _begin + kept;
+	_end = _cur + count;
+	return count != 0;
+}
+
+
+
+std::string_view Scanner::lexeme() const {
+	// Òåêóùèé ñèìâîë óæå âçÿò, êðîìå ïðîáåëà, ïîäñòàâëåííîãî íà êîíöå âõîäà
+	const char* end = is_stopped ? _cur : _cur - 1;
+	return std::string_view(_lexemeStart, end - _lexemeStart);
+}
+
+std::string_view Scanner::keep(std::string_view text) {
+	if (input_stream == nullptr)
+		return text;
+	if (_lexemes.size() < KeptLexemes) {
+		_lexemes.emplace_back(text);
+		return _lexemes.back();
+	}
+	// Êîëüöî çàïîëíåíî: ìåñòî ñàìîé ñòàðîé êîïèè çàíèìàåò íîâàÿ
+	std::string& slot = _lexemes[_nextLexeme];
+	_nextLexeme = (_nextLexeme + 1) % KeptLexemes;
+	slot.assign(text.data(), text.size());
+	return slot;
 }
 
 
@@ -21,8 +105,10 @@ Token Scanner::getNextToken() {
 
 	// Òåêóùèé ñèìâîë
 	char currentChar;
-	// Çíà÷åíèå
-	std::string value;
+	// Íàêîïëåííîå ÷èñëî èëè ñèìâîëüíàÿ êîíñòàíòà
+	int number = 0;
+	// ×èñëî âûøëî çà ïðåäåëû int
+	bool overflow = false;
 
 	// Ñáðîñ ñîñòîÿíèÿ â íîëü
 	State = 0;
@@ -30,264 +116,112 @@ Token Scanner::getNextToken() {
 
 	while (true)
 	{	
-		// Åñëè åñòü âîçâðàù¸ííûé ñèìâîë, òî âûáåðåì åãî
-		if (is_returned) {
-			currentChar = returnedChar;
-			is_returned = false;
-		}
-
-		// Èíà÷å, åñëè âõîä íåïóñòîé, âîçüì¸ì ñèìâîë îòòóäà
-		else if (!input_stream.eof()) {
-			currentChar = input_stream.get();
-			
-			// Åñëè ýòî áûë êîíåö ôàéëà, òî îáðàòîòàåì ïàðó ñëó÷àåâ è ïðîéä¸ì ïî àâòîìàòó ñ ñèìâîëîì ïðîáåëà,
-			// ÷òîá âûâåñòè íåçàâåðøèâøèåñÿ ÷èñëà, ëèòåðàëû è êëþ÷åâûå ñëîâà
-			if (input_stream.eof()) {
-				this->is_stopped = true;
-
-				// Îáðàáîòàåì îòäåëüíûå ñëó÷àè
-				if (State == 2)
-					return Token(LexemType::error, "Íåçàêðûòàÿ ñèìâîëüíàÿ êîíñòàíòà");
-				if (State == 4)
-					return Token(LexemType::error, "Íåçàêðûòàÿ ñòðîêîâàÿ êîíñòàíòà");
-
-				currentChar = ' ';
-			}
-		}
-		// Èíà÷å çàâåðøèòü
-		else {
+		// Ïîêà àâòîìàò â íà÷àëüíîì ñîñòîÿíèè, ëåêñåìà åù¸ íå íà÷àëàñü
+		if (State == 0)
+			_tokenStart = position();
+
+		// Åñëè âõîä èñ÷åðïàí, òî îáðàáîòàåì ïàðó ñëó÷àåâ è ïðîéä¸ì ïî àâòîìàòó ñ ñèìâîëîì ïðîáåëà,
+		// ÷òîá âûâåñòè íåçàâåðøèâøèåñÿ ÷èñëà, ëèòåðàëû è êëþ÷åâûå ñëîâà
+		if (!nextChar(currentChar)) {
+			// Ïðîáåë óæå áûë ïîäñòàâëåí - çàâåðøèòü
+			if (this->is_stopped)
+				return Token(LexemType::eof);
 			this->is_stopped = true;
-			return Token(LexemType::eof);
-		}
-
-
 
-		switch (State){
-			case 0:
-				if (currentChar == ' ' || currentChar == '\n' || currentChar == '\t')
-					continue;
-				if (currentChar == '>') {
-					return Token(LexemType::opgt);
-				}
-				if (currentChar == '*') {
-					return Token(LexemType::opmult);
-				}
-				if (punctuation.count(currentChar) > 0) {
-					return Token(punctuation[currentChar]);
-				}
+			// Îáðàáîòàåì îòäåëüíûå ñëó÷àè
+			if (State == 2)
+				return Token(LexemType::error, "Íåçàêðûòàÿ ñèìâîëüíàÿ êîíñòàíòà");
+			if (State == 4)
+				return Token(LexemType::error, "Íåçàêðûòàÿ ñòðîêîâàÿ êîíñòàíòà");
 
-				if ((currentChar - '0') >= 0 && (currentChar - '0') <= 9) {
-					value = currentChar;
-					State = 1;
-					continue;
-				}
-				if (currentChar == '\'') {
-					State = 2;
-					value = "";
-					continue;
-				}
-				if (currentChar == '"') {
-					State = 4;
-					value = "";
-					continue;
-				}
-				if (is_Letter(currentChar)) {
-					State = 5;
-					value = currentChar;
-					continue;
-				}
-				if (currentChar == '-') {
-					State = 6;
-					continue;
-				}
-				if (currentChar == '!') {
-					State = 7;
-					continue;
-				}
-				if (currentChar == '<') {
-					State = 8;
-					continue;
-				}
-				if (currentChar == '=') {
-					State = 9;
-					continue;
-				}
-				if (currentChar == '+') {
-					State = 10;
-					continue;
-				}
-				if (currentChar == '|') {
-					State = 11;
-					continue;
-				}
-				if (currentChar == '&') {
-					State = 12;
-					continue;
-				}
-
-				return Token(LexemType::error, "Íåïîääåðæèâàåìûé ÿçûêîì ñèìâîë");
-
-
-				break;
+			currentChar = ' ';
+		}
 
-			case 1:
-				// Îáðàáîòêà ÷èñåë
-				if ((currentChar - '0') >= 0 && (currentChar - '0') <= 9)
-					value += currentChar;
-				else {
-					returnedChar = currentChar;
-					is_returned = true;
-					State = 0;
-					return Token(std::stoi(value));
-				}
+		const LexTransition& transition = lexTransitions[State][charClasses[static_cast<unsigned char>(currentChar)]];
+		State = transition.next;
 
+		switch (transition.action) {
+			case LexAction::Skip:
+				// Ïðîáåëû ïðîïóñêàþòñÿ ñåðèåé
+				if (State == 0)
+					_cur = _kernels->spaces(_cur, _end);
 				break;
 
-			case 2:
-				// Òèï char
-				if (currentChar == '\'') {
-					is_stopped = true;
-					return Token(LexemType::error, "Ïóñòàÿ ñèìâîëüíàÿ êîíñòàíòà");
-				}
-				State = 3;
-				value = currentChar;
+			case LexAction::StartNumber:
+			{
+				number = currentChar - '0';
+				const char* stop = _kernels->digits(_cur, _end);
+				for (; _cur != stop; ++_cur)
+					overflow |= !appendDigit(number, *_cur);
 				break;
+			}
 
-			case 3:
-				if (currentChar == '\'') {
-					State = 0;
-					return Token(value[0]);
-				}
-				is_stopped = true;
-				return Token(LexemType::error, "Ñèìâîëüíàÿ êîíñòàíòà, ñîäåðæàùàÿ áîëåå îäíîãî ñèìâîëà");
-
-				break;
-
-			case 4:
-				// Òèï String
-				if (currentChar == '"') {
-					State = 0;
-					return Token(LexemType::str, value);
-				}
-
-				value += currentChar;
-
+			case LexAction::Number:
+				overflow |= !appendDigit(number, currentChar);
 				break;
 
-			case 5:
-				// Êëþ÷åâûå ñëîâà è èìåíà ïåðåìåííûõ è ôóíêöèé
-				if (is_Letter(currentChar) || ((currentChar >= '0' && currentChar <= '9')))
-					value += currentChar;
-				else {
-
-					returnedChar = currentChar;
-					is_returned = true;
-					State = 0;
+			case LexAction::EndNumber:
+				returnChar();
+				if (overflow)
+					return Token(LexemType::error, lexErrors[leNumberOverflow]);
+				return Token(number);
 
-					if (keywords.count(value) > 0)
-						return Token(keywords[value]);
-					else
-						return Token(LexemType::id, value);
-				}
+			case LexAction::StartId:
+				_lexemeStart = _cur - 1;
+				_cur = _kernels->identifier(_cur, _end);
 				break;
 
-			case 6:
-				// Îáðàáîòêà ìèíóñà
-				if (currentChar == '-') {
-					State = 0;
-					return Token(LexemType::opdec);
-				}
-				else {
-					returnedChar = currentChar;
-					is_returned = true;
-					State = 0;
-					return Token(LexemType::opminus);
-				}
-
+			case LexAction::StartStr:
+				_lexemeStart = _cur;
+				_cur = _kernels->string(_cur, _end);
 				break;
 
-			case 7:
-				if (currentChar == '=') {
-					State = 0;
-					return Token(LexemType::opne);
-				}
-				else {
-					returnedChar = currentChar;
-					is_returned = true;
-					State = 0;
-					return Token(LexemType::opnot);
-				}
-
+			case LexAction::Append:
+				// Ñåðèÿ, ïðåðâàííàÿ êîíöîì áëîêà ïîòîêà, ïðîäîëæàåòñÿ â íîâîì áëîêå
+				_cur = State == 4 ? _kernels->string(_cur, _end) : _kernels->identifier(_cur, _end);
 				break;
 
-			case 8:
-				if (currentChar == '=') {
-					State = 0;
-					return Token(LexemType::ople);
-				}
-				else {
-					returnedChar = currentChar;
-					is_returned = true;
-					State = 0;
-					return Token(LexemType::oplt);
-				}
-
-				break;
+			case LexAction::EndId:
+			{
+				std::string_view word = lexeme();
+				returnChar();
+				LexemType type = keywordType(word);
+				if (type != LexemType::id)
+					return Token(type);
+				if (_names != nullptr) {
+					NameId id = _names->intern(word);
+					return Token(LexemType::id, (*_names)[id], id);
+				}
+				return Token(LexemType::id, keep(word));
+			}
 
-			case 9:
-				if (currentChar == '=') {
-					State = 0;
-					return Token(LexemType::opeq);
-				}
-				else {
-					returnedChar = currentChar;
-					is_returned = true;
-					State = 0;
-					return Token(LexemType::opassign);
-				}
+			case LexAction::EndStr:
+				return Token(LexemType::str, keep(lexeme()));
 
+			case LexAction::StoreChr:
+				number = currentChar;
 				break;
 
-			case 10:
-				if (currentChar == '+') {
-					State = 0;
-					return Token(LexemType::opinc);
-				}
-				else {
-					returnedChar = currentChar;
-					is_returned = true;
-					State = 0;
-					return Token(LexemType::opplus);
-				}
-
-				break;
+			case LexAction::EndChr:
+				return Token(static_cast<char>(number));
 
-			case 11:
-				if (currentChar == '|') {
-					State = 0;
-					return Token(LexemType::opor);
-				}
-				else {
-					is_stopped = true;
-					return Token(LexemType::error, "Îäèíî÷íûé ñèìâîë |");
-				}
+			case LexAction::Emit:
+				return Token(static_cast<LexemType>(transition.arg));
 
-				break;
+			case LexAction::EmitSingle:
+				return Token(singleTokens[static_cast<unsigned char>(currentChar)]);
 
-			case 12:
-				if (currentChar == '&') {
-					State = 0;
-					return Token(LexemType::opand);
-				}
-				else {
-					is_stopped = true;
-					return Token(LexemType::error, "Îäèíî÷íûé ñèìâîë &");
-				}
+			case LexAction::EmitBack:
+				returnChar();
+				return Token(static_cast<LexemType>(transition.arg));
 
-				break;
+			case LexAction::Error:
+				return Token(LexemType::error, lexErrors[transition.arg]);
 
-			default:
-				break;
-			}
+			case LexAction::Fail:
+				is_stopped = true;
+				is_failed = true;
+				return Token(LexemType::error, lexErrors[transition.arg]);
+		}
 	}
 }
@@ -1,60 +1,85 @@
 #pragma once
 
+#include <deque>
 #include <iostream>
+#include <memory>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "Interner.h"
+#include "ScanKernels.h"
 #include "Token.h"
 
-#include <map>
-
-static std::map<char, LexemType> punctuation{
-										{'[',		LexemType::lbracket},
-										{']',		LexemType::rbracket},
-										{'(',		LexemType::lpar},
-										{')',		LexemType::rpar},
-										{'{',		LexemType::lbrace},
-										{'}',		LexemType::rbrace},
-										{';',		LexemType::semicolon},
-										{',',		LexemType::comma},
-										{':',		LexemType::colon}
-};
-static std::map<std::string, LexemType> keywords{
-										{"return",  LexemType::kwreturn},
-										{"int",     LexemType::kwint},
-										{"char",    LexemType::kwchar},
-										{"const",    LexemType::kwconst},
-										{"if",      LexemType::kwif},
-										{"else",    LexemType::kwelse},
-										{"switch",  LexemType::kwswitch},
-										{"case",    LexemType::kwcase},
-										{"default",    LexemType::kwdefault},
-										{"while",   LexemType::kwwhile},
-										{"for",     LexemType::kwfor},
-										{"in",      LexemType::kwin},
-										{"out",     LexemType::kwout}
-};
-
-
 class Scanner {
 public:
-	Scanner(std::istream& stream) : input_stream(stream) {};
+	static constexpr size_t DefaultChunkSize = 64 * 1024;
+	// Â ðåæèìå ïîòîêà òåêñò ñòðîêè (è èäåíòèôèêàòîðà áåç òàáëèöû èì¸í) îñòà¸òñÿ äåéñòâèòåëüíûì,
+	// ïîêà íå âûäàíû åù¸ KeptLexemes òàêèõ ëåêñåì: êîïèè ëåæàò â êîëüöå, è ïàìÿòü íå ðàñò¸ò ñ äëèíîé âõîäà.
+	// Ýòî áîëüøå, ÷åì ëåêñåì âìåùàåò TokenPipe, ïîýòîìó ïàðñåð óñïåâàåò âçÿòü òåêñò
+	static constexpr size_t KeptLexemes = 8192;
+
+	// names - òàáëèöà èì¸í, â êîòîðóþ çàíîñÿòñÿ èäåíòèôèêàòîðû; áåç íå¸ ó id íåò íîìåðà èìåíè.
+	// Ïîòîê ÷èòàåòñÿ áëîêàìè ïî chunkSize áàéò â îêíî, êîòîðîå ðàñò¸ò, òîëüêî åñëè â íåãî íå ïîìåùàåòñÿ îäíà ëåêñåìà
+	Scanner(std::istream& stream, Interner* names = nullptr, size_t chunkSize = DefaultChunkSize)
+		: input_stream(&stream), _window(new char[chunkSize]), _windowSize(chunkSize), _names(names), _kernels(&scanKernels()) {};
+	// Ñåðèè ïðîáåëîâ, ñèìâîëîâ èäåíòèôèêàòîðà, öèôð è òåëà ñòðîêè ïðîïóñêàþòñÿ âåêòîðíûìè ÿäðàìè kernels
+	Scanner(const char* begin, const char* end, Interner* names = nullptr, const ScanKernels& kernels = scanKernels())
+		: _begin(begin), _cur(begin), _end(end), _names(names), _kernels(&kernels) {};
 
 	Token getNextToken();
+	// Ñìåùåíèå îò íà÷àëà âõîäà äî ïåðâîãî ñèìâîëà ïîñëåäíåé âûäàííîé ëåêñåìû
+	size_t tokenOffset() const { return _tokenStart; };
+	// Ðàçáîð ïðåðâàí îøèáêîé, ïîñëå êîòîðîé âûäà¸òñÿ òîëüêî eof
+	bool failed() const { return is_failed; };
+	// Òåêñòû ëåêñåì æèâóò íåäîëãî (ðåæèì ïîòîêà, ñì. KeptLexemes): êòî õðàíèò ëåêñåìû, êîïèðóåò èõ
+	bool transientText() const { return input_stream != nullptr; };
 
 private:
-	// Âõîäíîé ïîòîê, îòêóäà áóäåì áðàòü ñèìâîëû
-	std::istream& input_stream;
+	// Âçÿòü î÷åðåäíîé ñèìâîë, false - åñëè âõîä èñ÷åðïàí
+	bool nextChar(char& c);
+	// Âåðíóòü ïîñëåäíèé âçÿòûé ñèìâîë îáðàòíî âî âõîä
+	void returnChar();
+	// Äî÷èòàòü ñëåäóþùèé áëîê ïîòîêà â îêíî, false - åñëè ïîòîê êîí÷èëñÿ
+	bool refill();
+	// Ñêîëüêî ñèìâîëîâ âõîäà óæå ïðî÷èòàíî
+	size_t position() const { return _windowOffset + (_cur - _begin); };
+	// Òåêñò ëåêñåìû îò _lexemeStart áåç òåêóùåãî ñèìâîëà
+	std::string_view lexeme() const;
+	// Ñäåëàòü òåêñò ëåêñåìû äîëãîâå÷íûì: â ðåæèìå áóôåðà îí è òàê ññûëàåòñÿ íà èñõîäíûé òåêñò,
+	// â ðåæèìå ïîòîêà îêíî ïåðåçàïèñûâàåòñÿ, ïîýòîìó òåêñò êîïèðóåòñÿ â êîëüöî _lexemes
+	std::string_view keep(std::string_view text);
+
+	// Âõîäíîé ïîòîê, îòêóäà áóäåì áðàòü ñèìâîëû (nullptr â ðåæèìå áóôåðà)
+	std::istream* input_stream = nullptr;
+	// Íà÷àëî, òåêóùàÿ ïîçèöèÿ è êîíåö òåêñòà: âåñü èñõîäíûé áóôåð èëè îêíî ïîòîêà
+	const char* _begin = nullptr;
+	const char* _cur = nullptr;
+	const char* _end = nullptr;
+	// Íà÷àëî òåêóùåé ëåêñåìû
+	const char* _lexemeStart = nullptr;
+	// Ñìåùåíèå íà÷àëà ïîñëåäíåé ëåêñåìû
+	size_t _tokenStart = 0;
+
+	// Ðåæèì ïîòîêà: îêíî, â êîòîðîå ÷èòàþòñÿ áëîêè, è ñìåùåíèå åãî íà÷àëà îò íà÷àëà ïîòîêà.
+	// Íåäî÷èòàííàÿ ëåêñåìà ïðè ïîäêà÷êå ïåðåíîñèòñÿ â íà÷àëî îêíà
+	std::unique_ptr<char[]> _window;
+	size_t _windowSize = 0;
+	size_t _windowOffset = 0;
+	// Êîëüöî èç KeptLexemes êîïèé òåêñòîâ ëåêñåì ïîòîêà è ìåñòî ñëåäóþùåé ïîñëå çàïîëíåíèÿ.
+	// deque íå ïåðåìåùàåò ýëåìåíòû, ïîêà êîëüöî ðàñò¸ò, ïîýòîìó âûäàííûå string_view îñòàþòñÿ äåéñòâèòåëüíûìè
+	std::deque<std::string> _lexemes;
+	size_t _nextLexeme = 0;
+	// Òàáëèöà èì¸í èäåíòèôèêàòîðîâ
+	Interner* _names = nullptr;
+	// Ïîèñê êîíöà ñåðèè ñèìâîëîâ â áóôåðå
+	const ScanKernels* _kernels = nullptr;
 	// Åñëè ìû óæå çàêîí÷èëè
 	bool is_stopped = false;
+	// Åñëè çàêîí÷èëè èç-çà îøèáêè
+	bool is_failed = false;
 	// Ñîñòîÿíèå
 	int State = 0;
-
-
-	// Âîçâðàù¸ííûé â ïîòîê ñèìâîë
-	char returnedChar = 0;
-	// Ôëàã, åñëè åñòü âîçâðàù¸ííûé ñèìâîë
-	bool is_returned = false;
 };
@@ -1,41 +1,123 @@
 #include "StringTable.h"
+#include <algorithm>
+#include <functional>
 #include <iomanip>
+#include <numeric>
 
 
-const std::string& StringTable::operator [](const int index) const {
-	if (index < 0 || index >= _strings.size()) {
+// Áàéò ñòðîêè â ïàìÿòè: àññåìáëåð îòäà¸ò escape-ïîñëåäîâàòåëüíîñòè ('\' è ñëåäóþùèé ñèìâîë) îäèí áàéò
+static size_t bytes(std::string_view text) {
+	size_t result = 0;
+	for (size_t i = 0; i < text.size(); ++i, ++result) {
+		if (text[i] == '\\' and i + 1 < text.size())
+			++i;
+	}
+	return result;
+}
+
+
+StringTable::StringTable() : _offsets{ 0 }, _slots(InitialSlots, Free), _mask{ InitialSlots - 1 } {}
+
+
+std::string_view StringTable::operator [](const int index) const {
+	if (index < 0 || index >= size()) {
 		throw std::exception("Index out of range");
 	}
-	return _strings[index];
+	return std::string_view(_arena.data() + _offsets[index], _offsets[index + 1] - _offsets[index]);
 }
 
 
-std::shared_ptr<StringOperand> StringTable::add(const std::string name) {
-	auto result = std::find(_strings.begin(), _strings.end(), name);
+size_t StringTable::home(std::string_view text) const {
+	return std::hash<std::string_view>()(text) & _mask;
+}
+
+
+Operand StringTable::add(std::string_view name) {
+	size_t i = home(name);
+	for (; _slots[i] != Free; i = (i + 1) & _mask) {
+		if ((*this)[_slots[i]] == name)
+			return Operand::string(_slots[i]);
+	}
+
+	int index = static_cast<int>(size());
+	_arena.append(name);
+	_offsets.push_back(static_cast<uint32_t>(_arena.size()));
+	_slots[i] = index;
+	if (2 * size() > _slots.size())
+		grow();
+	return Operand::string(index);
+}
+
 
-	if (result == _strings.end()) {
-		_strings.push_back(name);
-		return std::make_shared<StringOperand>(_strings.size() - 1, this);
+void StringTable::grow() {
+	_slots.assign(_slots.size() * 2, Free);
+	_mask = _slots.size() - 1;
+	for (int index = 0; index < size(); ++index) {
+		size_t i = home((*this)[index]);
+		while (_slots[i] != Free)
+			i = (i + 1) & _mask;
+		_slots[i] = index;
 	}
-	else
-		return std::make_shared<StringOperand>(result - _strings.begin(), this);
 }
 
 
-std::ostream& operator <<(std::ostream& stream, StringTable& sTable) {
+std::ostream& operator <<(std::ostream& stream, const StringTable& sTable) {
 	stream << "==  String Table:  ==\n---------------------\n";
 
-	for (int i = 0; i < sTable._strings.size(); i++) {
-		stream << std::setw(3) << i << " |  " << sTable._strings[i] << std::endl;
+	for (int i = 0; i < sTable.size(); i++) {
+		stream << std::setw(3) << i << " |  " << sTable[i] << std::endl;
 	}
 	return stream;
 }
 
 
+std::vector<StringTable::Placement> StringTable::layout() const {
+	std::vector<Placement> result(size());
+	for (int i = 0; i < size(); ++i)
+		result[i] = { i, 0 };
+
+	// Ïîñëå ñîðòèðîâêè ïî ïåðåâ¸ðíóòîìó òåêñòó ñòðîêà, êîòîðàÿ ÿâëÿåòñÿ êîíöîì äðóãîé, ñòîèò ñðàçó ïåðåä
+	// áëèæàéøåé òàêîé ñòðîêîé. Ïðîõîä ñ êîíöà ðàçìåùàåò êàæäóþ âíóòðè ìåñòà ñëåäóþùåé
+	std::vector<int> order(size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [this](int a, int b) {
+		std::string_view x = (*this)[a], y = (*this)[b];
+		return std::lexicographical_compare(x.rbegin(), x.rend(), y.rbegin(), y.rend());
+	});
+
+	for (int k = static_cast<int>(order.size()) - 2; k >= 0; --k) {
+		std::string_view text = (*this)[order[k]], next = (*this)[order[k + 1]];
+		if (next.size() < text.size() or next.substr(next.size() - text.size()) != text)
+			continue;
+
+		Placement place = result[order[k + 1]];
+		place.shift += static_cast<int>(next.size() - text.size());
+		// Ñäâèã ñ÷èòàåòñÿ â ñèìâîëàõ òåêñòà. Ïåðåä íà÷àëîì ñòðîêè íå äîëæíî áûòü '\',
+		// èíà÷å îí çàâèñèò îò òîãî, ñêîëüêî áàéò àññåìáëåð îòäà¸ò ïîä escape-ïîñëåäîâàòåëüíîñòü
+		if ((*this)[place.owner].substr(0, place.shift).find('\\') == std::string_view::npos)
+			result[order[k]] = place;
+	}
+	return result;
+}
+
+
 void StringTable::generateStrings(std::ostream& stream) const {
-	int count = 0;
-	for (auto item : _strings) {
-		stream << "str" << count << ": DB '" << item << "', 0" << '\n';
-		++count;
+	std::vector<Placement> places = layout();
+	size_t saved = 0;
+
+	for (int i = 0; i < size(); ++i) {
+		if (places[i].owner == i)
+			stream << "str" << i << ": DB '" << (*this)[i] << "', 0" << '\n';
+	}
+	for (int i = 0; i < size(); ++i) {
+		if (places[i].owner == i)
+			continue;
+		stream << "str" << i << " EQU str" << places[i].owner;
+		if (places[i].shift > 0)
+			stream << '+' << places[i].shift;
+		stream << '\n';
+		saved += bytes((*this)[i]) + 1;
 	}
+	if (saved > 0)
+		stream << "; " << saved << " bytes saved by sharing string tails" << '\n';
 }
@@ -1,21 +1,45 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <ostream>
 #include <iostream>
 
 #include "Atoms.h"
 
+// Òàáëèöà ñòðîêîâûõ ëèòåðàëîâ. Òåêñòû ëåæàò ïîäðÿä â îäíîì áóôåðå: ñòðîêà i - [_offsets[i], _offsets[i + 1]).
+// Ïîâòîðû íàõîäèò õåø-èíäåêñ ñ îòêðûòîé àäðåñàöèåé (êàê SymbolIndex): ñëîò õðàíèò íîìåð ñòðîêè èëè Free
 class StringTable {
 private:
-	std::vector<std::string> _strings;
+	std::string _arena;
+	std::vector<uint32_t> _offsets;
+
+	static constexpr int Free = -1;
+	static constexpr size_t InitialSlots = 16;
+	std::vector<int> _slots;
+	size_t _mask;
+
+	size_t home(std::string_view text) const;
+	void grow();
+
+	// Ìåñòî ñòðîêè â ðàçäåëå äàííûõ: ñòðîêà owner ñî ñäâèãîì shift (ó ñàìîñòîÿòåëüíîé - îíà ñàìà è 0)
+	struct Placement {
+		int owner;
+		int shift;
+	};
+	// Ñòðîêà, êîòîðàÿ ÿâëÿåòñÿ êîíöîì äðóãîé, ðàçìåùàåòñÿ âíóòðè íå¸
+	std::vector<Placement> layout() const;
 public:
-	StringTable() {};
-	const std::string& operator [] (const int index) const;
-	std::shared_ptr<StringOperand> add(const std::string name);
+	StringTable();
+	// Òåêñò ñòðîêè; äåéñòâèòåëåí äî ñëåäóþùåãî add
+	std::string_view operator [] (const int index) const;
+	Operand add(std::string_view name);
+	size_t size() const { return _offsets.size() - 1; };
 
+	// Ðàçäåë ñòðîê: ñàìîñòîÿòåëüíûå ñòðîêè - DB, ñîâïàäàþùèå ñ êîíöîì äðóãîé - EQU âíóòðü íå¸
 	void generateStrings(std::ostream&) const;
 
-	friend std::ostream& operator << (std::ostream&, StringTable&);
+	friend std::ostream& operator << (std::ostream&, const StringTable&);
 };
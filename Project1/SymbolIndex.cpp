@@ -0,0 +1,74 @@
+#include "SymbolIndex.h"
+
+
+SymbolIndex::SymbolIndex() : _slots(InitialSize, Slot{ Interner::Empty, 0, 0 }), _mask{ InitialSize - 1 } {}
+
+
+size_t SymbolIndex::home(NameId name, Scope scope) const {
+	// Óìíîæåíèå Ôèáîíà÷÷è: ñòàðøèå áèòû ïðîèçâåäåíèÿ ðàâíîìåðíî çàâèñÿò îò îáåèõ ïîëîâèí êëþ÷à
+	uint64_t key = (static_cast<uint64_t>(name) << 32) | static_cast<uint32_t>(scope);
+	return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & _mask;
+}
+
+
+int SymbolIndex::find(NameId name, Scope scope) const {
+	for (size_t i = home(name, scope);; i = (i + 1) & _mask) {
+		const Slot& slot = _slots[i];
+		if (slot.name == Interner::Empty)
+			return NotFound;
+		if (slot.name == name and slot.scope == scope)
+			return slot.value;
+	}
+}
+
+
+void SymbolIndex::set(NameId name, Scope scope, int value) {
+	if (2 * (_count + 1) > _slots.size())
+		grow();
+
+	size_t i = home(name, scope);
+	while (_slots[i].name != Interner::Empty) {
+		if (_slots[i].name == name and _slots[i].scope == scope) {
+			_slots[i].value = value;
+			return;
+		}
+		i = (i + 1) & _mask;
+	}
+	_slots[i] = { name, scope, value };
+	++_count;
+}
+
+
+void SymbolIndex::erase(NameId name, Scope scope) {
+	size_t i = home(name, scope);
+	while (_slots[i].name != name or _slots[i].scope != scope) {
+		if (_slots[i].name == Interner::Empty)
+			return;
+		i = (i + 1) & _mask;
+	}
+
+	// Ñëîòû çà îñâîáîæä¸ííûì, êîòîðûå íå äîñòèæèìû áåç íåãî, ñäâèãàþòñÿ íà åãî ìåñòî
+	for (size_t j = (i + 1) & _mask; _slots[j].name != Interner::Empty; j = (j + 1) & _mask) {
+		size_t k = home(_slots[j].name, _slots[j].scope);
+		// Ñëîò j îñòà¸òñÿ, åñëè åãî äîìàøíÿÿ ïîçèöèÿ k ëåæèò â öåïî÷êå ìåæäó i è j
+		bool stays = i <= j ? (i < k and k <= j) : (i < k or k <= j);
+		if (!stays) {
+			_slots[i] = _slots[j];
+			i = j;
+		}
+	}
+	_slots[i].name = Interner::Empty;
+	--_count;
+}
+
+
+void SymbolIndex::grow() {
+	std::vector<Slot> old(_slots.size() * 2, Slot{ Interner::Empty, 0, 0 });
+	old.swap(_slots);
+	_mask = _slots.size() - 1;
+	_count = 0;
+	for (auto& slot : old) {
+		if (slot.name != Interner::Empty)
+			set(slot.name, slot.scope, slot.value);
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Interner.h"
+
+typedef int Scope;
+
+const Scope GlobalScope = -1;
+
+// Õåø-èíäåêñ òàáëèöû ñèìâîëîâ: ïàðà (èìÿ, îáëàñòü) -> ÷èñëî (íîìåð çàïèñè èëè ñ÷¸ò÷èê).
+// Îòêðûòàÿ àäðåñàöèÿ ñ ëèíåéíûì ïðîáèðîâàíèåì, ðàçìåð - ñòåïåíü äâîéêè, çàïîëíåíèå íå âûøå ïîëîâèíû.
+// Ñâîáîäíûé ñëîò - ñëîò ñ ïóñòûì èìåíåì, ïîýòîìó âðåìåííûå ïåðåìåííûå â èíäåêñ íå ïîïàäàþò.
+// Óäàëåíèå ñäâèãàåò ñëåäóþùèå ñëîòû öåïî÷êè íàçàä, áåç íàäãðîáèé
+class SymbolIndex {
+public:
+	static constexpr int NotFound = -1;
+
+	SymbolIndex();
+
+	int find(NameId name, Scope scope) const;
+	// Äîáàâèòü ïàðó èëè çàìåíèòü å¸ çíà÷åíèå
+	void set(NameId name, Scope scope, int value);
+	void erase(NameId name, Scope scope);
+
+	size_t size() const { return _count; };
+
+private:
+	struct Slot {
+		NameId name;
+		Scope scope;
+		int value;
+	};
+
+	static constexpr size_t InitialSize = 64;
+
+	size_t home(NameId name, Scope scope) const;
+	void grow();
+
+	std::vector<Slot> _slots;
+	size_t _mask;
+	size_t _count = 0;
+};
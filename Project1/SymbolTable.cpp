@@ -1,4 +1,3 @@
-#include <algorithm>
 #include <iomanip>
 #include <exception>
 
@@ -7,6 +6,8 @@
 
 typedef SymbolTable::TableRecord TSrec;
 
+static_assert(sizeof(TSrec) == 16, "TableRecord äîëæíà çàíèìàòü 16 áàéò");
+
 const TSrec& SymbolTable::operator[](const int index) const {
 	if (index < 0 || index >= _records.size()) {
 		throw std::exception("Index out of range");
@@ -15,145 +16,201 @@ const TSrec& SymbolTable::operator[](const int index) const {
 }
 
 
+SymbolTable::RecordRange SymbolTable::locals(Scope scope) const {
+	const TableRecord* first = _records.data() + scope + 1;
+	return { first, first + _functionSize[_records[scope]._ordinal] };
+}
+
+
 int SymbolTable::getM(Scope scope) const {
-	int n = _records[scope]._len; // êîëè÷åñòâî àðãóìåíòîâ ôóíêöèè
-	int m = 0;                    // Èñêîìîå M - êîëè÷åñòâî ëîêàëüíûõ è âðåìåííûõ ïåðåìåííûõ
-	int vars = 0;                 // êîëè÷åñòâî ïåðåìåííûõ â scope
-	for (auto& record : _records) {
-		if (record._scope == scope)
-			++vars;
-	}
+	int n = _records[scope]._len;    // êîëè÷åñòâî àðãóìåíòîâ ôóíêöèè
+	int vars = _functionSize[_records[scope]._ordinal]; // êîëè÷åñòâî ïåðåìåííûõ â scope
+	return vars - n;                  // M - êîëè÷åñòâî ëîêàëüíûõ è âðåìåííûõ ïåðåìåííûõ
+}
+
 
-	m = vars - n;
-	return m;
+void SymbolTable::setOffset(TableRecord& record, const TableRecord& func, int j) {
+	int n = func._len;
+	int m = _functionSize[func._ordinal] - n;
+	// Êàäð àäðåñóåòñÿ 16-áèòíûì LXI H
+	if (2 * (m + n + 1) > TableRecord::NoOffset)
+		throw std::exception(("Êàäð ôóíêöèè " + std::string(_names[func._name]) + " áîëüøå 64 ÊÁ").c_str());
+	if (j <= n) {
+		record._offset = static_cast<uint16_t>(2 * (m + n + 1 - j));
+	}
+	else {
+		record._offset = static_cast<uint16_t>(2 * (m + n - j));
+	}
 }
 
 
 void SymbolTable::calculateOffset() {
-	for (int i = 0; i < _records.size(); ++i) {
-		if (_records[i]._kind == TSrec::RecordKind::var and _records[i]._scope != GlobalScope) {
-			int m = getM(_records[i]._scope);
-			int n = _records[_records[i]._scope]._len;
-			int j = i - _records[i]._scope;
-			if (j <= n) {
-				_records[i]._offset = 2 * (m + n + 1 - j);
-			}
-			else if (j > n) {
-				_records[i]._offset = 2 * (m + n - j);
-			}
-		}
-	}
+	if (_laidOut)
+		return;
+
+	for (Scope scope : _functions)
+		calculateOffset(scope);
+	_laidOut = true;
+}
+
+void SymbolTable::calculateOffset(Scope scope) {
+	const TableRecord& func = _records[scope];
+	int vars = _functionSize[func._ordinal];
+	for (int j = 1; j <= vars; ++j)
+		setOffset(_records[scope + j], func, j);
 }
 
-std::vector<std::string> SymbolTable::functionNames() const {
-	std::vector<std::string> result;
-	for (auto& item : _records) {
-		if (item._kind == TSrec::RecordKind::func)
-			result.push_back(item._name);
+void SymbolTable::release(Scope scope) {
+	int& vars = _functionSize[_records[scope]._ordinal];
+	if (scope + 1 + vars != _records.size())
+		throw std::exception("release: çàïèñè ôóíêöèè íå ïîñëåäíèå â òàáëèöå");
+
+	for (int i = scope + 1; i < _records.size(); ++i)
+		_cold.erase(i);
+	for (auto& record : locals(scope)) {
+		if (record._name == Interner::Empty)
+			continue;
+		// Ñ÷¸ò÷èê (èìÿ, AnyScope) îñòà¸òñÿ: addFunc íå äîëæíà ïðèíÿòü èìÿ ïåðåìåííîé
+		// óæå îñâîáîæä¸ííîé ôóíêöèè, êàê íå ïðèíèìàåò åãî translate()
+		_index.erase(record._name, scope);
 	}
-	return result;
+	_records.erase(_records.begin() + scope + 1, _records.end());
+	vars = 0;
+	_openFunction = GlobalScope;
+	_laidOut = false;
 }
 
 
 void SymbolTable::generateGlobals(std::ostream& stream) const {
-	int count = 0;
-	for (auto item : _records) {
-		if (item._kind == TSrec::RecordKind::var and
-			item._scope == GlobalScope)
-		{
-			stream << "var" << count << ": DB " << item._init << '\n';
-			++count;
-		}
-	}
+	for (size_t i = 0; i < _globals.size(); ++i)
+		stream << "var" << i << ": DB " << init(_globals[i]) << '\n';
 }
 
 
 
-std::shared_ptr<MemoryOperand> SymbolTable::addVar(const std::string& name,
-												   const Scope scope,
-												   const TableRecord::RecordType type,
-												   const int init,
-												   const bool is_const)
+Operand SymbolTable::addVar(const NameId name,
+							const Scope scope,
+							const TableRecord::RecordType type,
+							const int init,
+							const bool is_const)
 {
-	auto is_ok = [&name, &scope](TSrec& tsr) {
-		return (tsr._name == name) and (tsr._scope == scope);
-	};
-
-	auto result = std::find_if(_records.begin(), _records.end(), is_ok);
-	if (result == _records.end()) {
-		_records.push_back(TSrec(name, TSrec::RecordKind::var, type, 0, init, scope, is_const));
-		return std::make_shared<MemoryOperand>(_records.size() - 1, this);
+	if (lookup(name, scope) == SymbolIndex::NotFound) {
+		push(TSrec(name, TSrec::RecordKind::var, type, scope, is_const), init);
+		return Operand::memory(static_cast<int>(_records.size() - 1));
 	}
 	else {
-		return nullptr;
+		return {};
 	}
 }
 
 
-std::shared_ptr<MemoryOperand> SymbolTable::addFunc(const std::string& name,
-												    const TableRecord::RecordType type,
-												    const int len)
+Operand SymbolTable::addFunc(const NameId name,
+							 const TableRecord::RecordType type,
+							 const int len)
 {
-	auto is_ok = [&name](TSrec& tsr) {
-		return tsr._name == name;
-	};
-
-	auto result = std::find_if(_records.begin(), _records.end(), is_ok);
-	if (result == _records.end()) {
-		_records.push_back(TSrec(name, TSrec::RecordKind::func, type, len, 0, GlobalScope));
-		return std::make_shared<MemoryOperand>(_records.size() - 1, this);
+	// Èìÿ ôóíêöèè íå äîëæíî âñòðå÷àòüñÿ íè â îäíîé îáëàñòè
+	if (lookup(name, AnyScope) == SymbolIndex::NotFound) {
+		push(TSrec(name, TSrec::RecordKind::func, type, GlobalScope), 0);
+		return Operand::memory(static_cast<int>(_records.size() - 1));
 	}
 	else {
-		return nullptr;
+		return {};
 	}
 }
 
 
-std::shared_ptr<MemoryOperand> SymbolTable::checkVar(const Scope scope,
-													 const std::string& name)
+Operand SymbolTable::checkVar(const Scope scope,
+							  const NameId name)
 {
-	auto is_ok = [&name, &scope](TSrec& tsr) { return (tsr._name == name) and (tsr._scope == scope); };
+	int result = lookup(name, scope);
 
-	auto result = std::find_if(_records.begin(), _records.end(), is_ok);
-
-	if ((result == _records.end()) and (scope != GlobalScope)) {
-		auto is_ok = [&name](TSrec& tsr) { return (tsr._name == name) and (tsr._scope == GlobalScope); };
-		result = std::find_if(_records.begin(), _records.end(), is_ok);
+	if ((result == SymbolIndex::NotFound) and (scope != GlobalScope)) {
+		result = lookup(name, GlobalScope);
 	}
-	if (result == _records.end() or result->_kind != TSrec::RecordKind::var) {
-		return nullptr;
+	if (result == SymbolIndex::NotFound or _records[result]._kind != TSrec::RecordKind::var) {
+		return {};
 	}
-	return std::make_shared<MemoryOperand>(result - _records.begin(), this);
+	return Operand::memory(result);
 }
 
 
-std::shared_ptr<MemoryOperand> SymbolTable::checkFunc(const std::string& name,
-													  int len)
+Operand SymbolTable::checkFunc(const NameId name,
+							   int len)
 {
-	auto is_ok = [&name](TSrec& tsr) {
-		return (tsr._name == name) and (tsr._scope == GlobalScope);
-	};
-
-	auto result = std::find_if(_records.begin(), _records.end(), is_ok);
-	if (result == _records.end() or result->_kind != TSrec::RecordKind::func) {
-		return nullptr;
+	int result = lookup(name, GlobalScope);
+	if (result == SymbolIndex::NotFound or _records[result]._kind != TSrec::RecordKind::func) {
+		return {};
 	}
 	else {
-		if (result->_len == len) {
-			return std::make_shared<MemoryOperand>(result - _records.begin(), this);
+		if (_records[result]._len == len) {
+			return Operand::memory(result);
 		}
 	}
-	return nullptr;
+	return {};
+}
+
+
+
+Operand SymbolTable::alloc(Scope scope) {
+	push(TSrec(Interner::Empty, TSrec::RecordKind::var, TSrec::RecordType::integer, scope), 0);
+	return Operand::memory(static_cast<int>(_records.size() - 1));
+}
+
+int SymbolTable::lookup(NameId name, Scope scope) const {
+	int result = _index.find(name, scope);
+	if (result == SymbolIndex::NotFound)
+		++_lookupStats.misses;
+	else
+		++_lookupStats.hits;
+	return result;
+}
+
+Operand SymbolTable::addRecord(const TableRecord& record, int init) {
+	push(record, init);
+	return Operand::memory(static_cast<int>(_records.size() - 1));
 }
 
+int SymbolTable::init(int index) const {
+	auto cold = _cold.find(index);
+	return cold == _cold.end() ? 0 : cold->second;
+}
 
+void SymbolTable::push(const TableRecord& record, int init) {
+	if (record._scope != GlobalScope and record._scope != _openFunction)
+		throw std::exception("Çàïèñè ôóíêöèè äîëæíû èäòè ïîäðÿä çà å¸ çàïèñüþ");
+
+	_laidOut = false;
+	Scope index = static_cast<Scope>(_records.size());
+	_records.push_back(record);
+	if (record._kind == TSrec::RecordKind::func) {
+		if (_functions.size() > UINT16_MAX)
+			throw std::exception("Ñëèøêîì ìíîãî ôóíêöèé");
+		_records.back()._ordinal = static_cast<uint16_t>(_functions.size());
+		_functions.push_back(index);
+		_functionSize.push_back(0);
+		_openFunction = index;
+	}
+	else if (record._scope == GlobalScope) {
+		if (_globals.size() > UINT16_MAX)
+			throw std::exception("Ñëèøêîì ìíîãî ãëîáàëüíûõ ïåðåìåííûõ");
+		_records.back()._dataIndex = static_cast<uint16_t>(_globals.size());
+		_globals.push_back(index);
+		_openFunction = GlobalScope;
+	}
+	else {
+		++_functionSize[_records[record._scope]._ordinal];
+	}
+	if (init != 0)
+		_cold[index] = init;
 
-std::shared_ptr<MemoryOperand> SymbolTable::alloc(Scope scope) {
-	_records.push_back(TSrec("", TSrec::RecordKind::var, TSrec::RecordType::integer, 0, 0, scope));
-	return std::make_shared<MemoryOperand>(_records.size() - 1, this);
+	if (record._name != Interner::Empty) {
+		_index.set(record._name, record._scope, static_cast<int>(_records.size() - 1));
+		int count = _index.find(record._name, AnyScope);
+		_index.set(record._name, AnyScope, count == SymbolIndex::NotFound ? 1 : count + 1);
+	}
 }
 
-std::ostream& operator << (std::ostream& stream, SymbolTable symbolTable) {
+std::ostream& operator << (std::ostream& stream, const SymbolTable& symbolTable) {
 	stream << "=====  Symbol Table  =====\n";
 
 
@@ -193,11 +250,11 @@ std::ostream& operator << (std::ostream& stream, SymbolTable symbolTable) {
 		stream << std::setiosflags(std::ios::left) << std::setw(10);
 		stream << line++;
 		stream << std::setiosflags(std::ios::left) << std::setw(10);
-		if (item._name.size() == 0) {
+		if (item._name == Interner::Empty) {
 			stream << "TMP" + std::to_string(line - 1);
 		}
 		else {
-			stream << item._name;
+			stream << symbolTable._names[item._name];
 		}
 
 
@@ -235,7 +292,7 @@ std::ostream& operator << (std::ostream& stream, SymbolTable symbolTable) {
 
 
 		stream << std::setiosflags(std::ios::left) << std::setw(10);
-		stream << item._init;
+		stream << symbolTable.init(line - 1);
 
 
 		stream << std::setiosflags(std::ios::left) << std::setw(10);
@@ -243,7 +300,12 @@ std::ostream& operator << (std::ostream& stream, SymbolTable symbolTable) {
 
 
 		stream << std::setiosflags(std::ios::left) << std::setw(10);
-		stream << item._offset;
+		if (item._offset != SymbolTable::TableRecord::NoOffset) {
+			stream << item._offset;
+		}
+		else {
+			stream << -1;
+		}
 
 
 
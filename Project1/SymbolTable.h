@@ -1,74 +1,159 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <iostream>
+#include <unordered_map>
 
 #include "Atoms.h"
-
-typedef int Scope;
-
-const Scope GlobalScope = -1;
+#include "Interner.h"
+#include "SymbolIndex.h"
 
 class SymbolTable {
 public:
+	// Çàïèñü çàíèìàåò 16 áàéò: âñ¸, ÷òî íóæíî ðàçáîðó è ïîðîæäåíèþ êîäà. Íà÷àëüíîå çíà÷åíèå
+	// íóæíî ðåäêî è ëåæèò îòäåëüíî (SymbolTable::init)
 	struct TableRecord {
-		enum class RecordKind { unknown, var, func };
-		enum class RecordType { unknown, integer, chr };
-
-		std::string _name;
-		RecordKind _kind;
-		RecordType _type;
-		int _len;
-		int _init;
+		enum class RecordKind : uint8_t { unknown, var, func };
+		enum class RecordType : uint8_t { unknown, integer, chr };
+
+		// Ñìåùåíèå åù¸ íå ïîñ÷èòàíî èëè ó çàïèñè åãî íåò
+		static constexpr uint16_t NoOffset = UINT16_MAX;
+
+		NameId _name;
 		Scope _scope;
-		int _offset;
-		bool _is_const;
+		// ×èñëî ïàðàìåòðîâ ôóíêöèè, -1 - íå çàäàíî (è ó ïåðåìåííûõ)
+		int16_t _len;
+		// Ñìåùåíèå ëîêàëüíîé ïåðåìåííîé â êàäðå
+		uint16_t _offset;
+		union {
+			// Ïîðÿäêîâûé íîìåð ôóíêöèè (íîìåð å¸ ñïèñêà àòîìîâ)
+			uint16_t _ordinal;
+			// Íîìåð N ìåòêè varN ãëîáàëüíîé ïåðåìåííîé â ðàçäåëå äàííûõ
+			uint16_t _dataIndex;
+		};
+		// Âèä, òèï è ïðèçíàê êîíñòàíòû äåëÿò îäèí áàéò
+		RecordKind _kind : 2;
+		RecordType _type : 2;
+		bool _is_const : 1;
 
-		TableRecord(std::string s, RecordKind kind, RecordType type, int len, int init, Scope scope, bool is_const = false) : _name{ s }, _kind{ kind }, _type{ type }, _len{ -1 }, _init{ init }, _scope{ scope }, _offset{ -1 }, _is_const{is_const} {}
+		TableRecord(NameId name, RecordKind kind, RecordType type, Scope scope, bool is_const = false)
+			: _name{ name }, _scope{ scope }, _len{ -1 }, _offset{ NoOffset }, _ordinal{ 0 }, _kind{ kind }, _type{ type }, _is_const{ is_const } {}
 	};
 
+	SymbolTable(const Interner& names) : _names{ names } {};
+
 	const TableRecord& operator[] (const int index) const;
+	// Èìÿ çàïèñè (ïóñòîå ó âðåìåííûõ ïåðåìåííûõ)
+	std::string_view name(const int index) const { return _names[_records[index]._name]; };
+
+	Operand addVar(const NameId name,
+				   const Scope scope,
+				   const TableRecord::RecordType type,
+				   const int init = 0,
+				   const bool is_const = false);
+
+	Operand addFunc(const NameId name,
+					const TableRecord::RecordType type,
+					const int len);
 
-	std::shared_ptr<MemoryOperand> addVar(const std::string& name,
-										  const Scope scope,
-										  const TableRecord::RecordType type,
-										  const int init = 0,
-										  const bool is_const = false);
+	Operand checkVar(const Scope scope,
+					 const NameId name);
 
-	std::shared_ptr<MemoryOperand> addFunc(const std::string& name,
-										   const TableRecord::RecordType type,
-										   const int len);
+	Operand checkFunc(const NameId name,
+					  int len);
 
-	std::shared_ptr<MemoryOperand> checkVar(const Scope scope,
-											const std::string& name);
+	Operand alloc(Scope);
 
-	std::shared_ptr<MemoryOperand> checkFunc(const std::string& name,
-											 int len);
+	// Äîáàâèòü ãîòîâóþ çàïèñü áåç ïðîâåðêè ïîâòîðîâ (ïàðàëëåëüíûé ðàçáîð); ôóíêöèÿ ïîëó÷àåò ñëåäóþùèé ïîðÿäêîâûé íîìåð
+	Operand addRecord(const TableRecord& record, int init = 0);
 
-	std::shared_ptr<MemoryOperand> alloc(Scope);
+	// Íà÷àëüíîå çíà÷åíèå ïåðåìåííîé
+	int init(int index) const;
+	bool isConst(int index) const { return _records[index]._is_const; };
 
+	// Çàïèñè ïîäðÿä, [begin, end)
+	struct RecordRange {
+		const TableRecord* _begin;
+		const TableRecord* _end;
+
+		const TableRecord* begin() const { return _begin; };
+		const TableRecord* end() const { return _end; };
+		size_t size() const { return _end - _begin; };
+	};
+
+	// ×èñëî ôóíêöèé; ïîðÿäêîâûå íîìåðà âûäà¸ò addFunc ïîäðÿä ñ íóëÿ
+	int functionCount() const { return static_cast<int>(_functions.size()); };
+	// Íîìåðà çàïèñåé ôóíêöèé ïî èõ ïîðÿäêîâûì íîìåðàì
+	const std::vector<Scope>& functions() const { return _functions; };
+	// Çàïèñè ôóíêöèè ïîñëå å¸ ñîáñòâåííîé: ïàðàìåòðû, çàòåì ëîêàëüíûå è âðåìåííûå ïåðåìåííûå
+	RecordRange locals(Scope scope) const;
+	// ×èñëî ëîêàëüíûõ è âðåìåííûõ ïåðåìåííûõ ôóíêöèè
 	int getM(Scope) const;
+	// Ñìåùåíèÿ ïåðåìåííûõ âñåõ ôóíêöèé. Ïîâòîðíûé âûçîâ áåç íîâûõ çàïèñåé íè÷åãî íå äåëàåò
 	void calculateOffset();
-	std::vector<std::string> functionNames() const;
+	// Ñìåùåíèÿ ïåðåìåííûõ îäíîé ôóíêöèè, ïðîõîä òîëüêî ïî å¸ çàïèñÿì
+	void calculateOffset(Scope);
+	// Óäàëèòü çàïèñè ôóíêöèè scope ïîñëå å¸ ñîáñòâåííîé (ïàðàìåòðû, ëîêàëüíûå è âðåìåííûå ïåðåìåííûå).
+	// Ôóíêöèÿ äîëæíà áûòü ïîñëåäíåé â òàáëèöå; íîìåðà îñâîáîæä¸ííûõ çàïèñåé âûäàþòñÿ çàíîâî.
+	// Èìåíà îñâîáîæä¸ííûõ ïåðåìåííûõ ïî-ïðåæíåìó ñ÷èòàþòñÿ çàíÿòûìè äëÿ addFunc
+	void release(Scope);
 	void generateGlobals(std::ostream& stream) const;
 
-	friend std::ostream& operator << (std::ostream& stream, SymbolTable);
-
-	void set_len_for_func(std::string name, int new_len) {
-		auto is_ok = [&name](TableRecord& tsr) {
-			return (tsr._name == name) and (tsr._scope == GlobalScope);
-		};
+	friend std::ostream& operator << (std::ostream& stream, const SymbolTable&);
 
-		auto result = std::find_if(_records.begin(), _records.end(), is_ok);
-		if (result != _records.end() and result->_kind == TableRecord::RecordKind::func) {
-			if (result->_len == -1) {
-				result->_len = new_len;
+	void set_len_for_func(const NameId name, int new_len) {
+		int result = lookup(name, GlobalScope);
+		if (result != SymbolIndex::NotFound and _records[result]._kind == TableRecord::RecordKind::func) {
+			if (_records[result]._len == -1) {
+				if (new_len > INT16_MAX)
+					throw std::exception("Ñëèøêîì ìíîãî ïàðàìåòðîâ ôóíêöèè");
+				_records[result]._len = static_cast<int16_t>(new_len);
+				_laidOut = false;
 			}
 		}
 	}
 
+	// Ïîïàäàíèÿ è ïðîìàõè ïîèñêà èì¸í (addVar, addFunc, checkVar, checkFunc, set_len_for_func)
+	struct LookupStats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+	};
+	const LookupStats& lookupStats() const { return _lookupStats; };
+
 	std::vector<TableRecord> _records;
+
+private:
+	// Äîáàâèòü çàïèñü è çàíåñòè å¸ èìÿ â èíäåêñ. Òàáëèöà äåëèòñÿ íà ãëîáàëüíûé ðàçäåë è ó÷àñòêè ôóíêöèé:
+	// çàïèñè ôóíêöèè èäóò ñðàçó çà å¸ ñîáñòâåííîé, äî ñëåäóþùåé ãëîáàëüíîé çàïèñè
+	void push(const TableRecord& record, int init);
+	// Íîìåð çàïèñè (èìÿ, îáëàñòü) èëè SymbolIndex::NotFound; ñ÷èòàåòñÿ â lookupStats
+	int lookup(NameId name, Scope scope) const;
+
+	const Interner& _names;
+	// Íîìåðà çàïèñåé ôóíêöèé ïî ïîðÿäêîâûì íîìåðàì
+	std::vector<Scope> _functions;
+	// ×èñëî çàïèñåé êàæäîé ôóíêöèè (ïàðàìåòðû, ëîêàëüíûå è âðåìåííûå ïåðåìåííûå) ïî ïîðÿäêîâûì íîìåðàì
+	std::vector<int> _functionSize;
+	// Íîìåðà çàïèñåé ãëîáàëüíûõ ïåðåìåííûõ ïî íîìåðàì èõ ìåòîê varN
+	std::vector<Scope> _globals;
+
+	// Íà÷àëüíûå çíà÷åíèÿ ïî íîìåðàì çàïèñåé; åñòü òîëüêî ó ïåðåìåííûõ ñ íåíóëåâûì çíà÷åíèåì
+	std::unordered_map<int, int> _cold;
+	// Ôóíêöèÿ, â ó÷àñòîê êîòîðîé äîáàâëÿþòñÿ çàïèñè, èëè GlobalScope
+	Scope _openFunction = GlobalScope;
+	// Ñìåùåíèÿ, ïîñ÷èòàííûå calculateOffset(), ñîîòâåòñòâóþò òåêóùèì çàïèñÿì
+	bool _laidOut = false;
+	// Ñìåùåíèå ïåðåìåííîé, j - å¸ ìåñòî çà çàïèñüþ ôóíêöèè (1..n - ïàðàìåòðû)
+	void setOffset(TableRecord& record, const TableRecord& func, int j);
+
+	// (èìÿ, îáëàñòü) -> íîìåð çàïèñè; (èìÿ, AnyScope) -> ÷èñëî çàïèñåé ñ ýòèì èìåíåì âî âñåõ îáëàñòÿõ.
+	// Ïàðà (èìÿ, îáëàñòü) ó èìåíîâàííûõ çàïèñåé åäèíñòâåííà: addVar è addFunc íå äîïóñêàþò ïîâòîðîâ
+	SymbolIndex _index;
+	static constexpr Scope AnyScope = -2;
+	mutable LookupStats _lookupStats;
 };
 
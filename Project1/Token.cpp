@@ -9,25 +9,31 @@ Token::Token(int value) {
 	this->_value = value;
 }
 
-Token::Token(LexemType type, const std::string& str) {
+Token::Token(LexemType type, std::string_view str) {
 	this->_type = type;
 	this->_str = str;
 }
 
+Token::Token(LexemType type, std::string_view str, int value) {
+	this->_type = type;
+	this->_str = str;
+	this->_value = value;
+}
+
 Token::Token(char c) {
 	this->_type = LexemType::chr;
 	this->_value = c;
 }
 
-LexemType Token::type() {
+LexemType Token::type() const {
 	return this->_type;
 }
 
-int Token::value() {
+int Token::value() const {
 	return this->_value;
 }
 
-std::string Token::str() {
+std::string_view Token::str() const {
 	return this->_str;
 }
 std::string lexem_type_to_string(LexemType type) {
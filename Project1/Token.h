@@ -3,6 +3,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 enum class LexemType { num, chr, str, id,
@@ -16,17 +17,21 @@ public:
 	Token() {}
 	Token(LexemType type);
 	Token(int value);
-	Token(LexemType type, const std::string& str);
+	Token(LexemType type, std::string_view str);
+	Token(LexemType type, std::string_view str, int value);
 	Token(char c);
 
 	void print(std::ostream& stream);
-	LexemType type();
-	int value();
-	std::string str();
+	LexemType type() const;
+	// Çíà÷åíèå num è chr, íîìåð èìåíè (NameId) ó id
+	int value() const;
+	// Òåêñò èäåíòèôèêàòîðà, ñòðîêè èëè îøèáêè. Ññûëàåòñÿ íà ïàìÿòü ñêàíåðà (èñõîäíûé áóôåð)
+	// èëè òàáëèöû èì¸í, äåéñòâèòåëåí, ïîêà îíè æèâû
+	std::string_view str() const;
 
 
 private:
 	LexemType _type;
 	int _value = 0;
-	std::string _str = "";
+	std::string_view _str;
 };
@@ -0,0 +1,81 @@
+#include "TokenBuffer.h"
+
+
+void TokenBuffer::fill(Scanner& scanner) {
+	while (true) {
+		Token token = scanner.getNextToken();
+		push(token, scanner.tokenOffset(), scanner.transientText());
+		if (token.type() == LexemType::eof)
+			return;
+	}
+}
+
+
+void TokenBuffer::append(const TokenBuffer& other, const std::vector<NameId>& names, size_t offset, bool withEof) {
+	size_t count = other.size();
+	if (!withEof and count != 0 and other.type(count - 1) == LexemType::eof)
+		--count;
+
+	int32_t textBase = static_cast<int32_t>(_texts.size());
+	_texts.insert(_texts.end(), other._texts.begin(), other._texts.end());
+
+	for (size_t i = 0; i < count; ++i) {
+		LexemType type = other.type(i);
+		int32_t value = other._values[i];
+		if (type == LexemType::id)
+			value = static_cast<int32_t>(names[value]);
+		else if (type == LexemType::str or type == LexemType::error)
+			value += textBase;
+
+		_types.push_back(other._types[i]);
+		_values.push_back(value);
+		_offsets.push_back(static_cast<uint32_t>(other._offsets[i] + offset));
+	}
+}
+
+
+void TokenBuffer::reserve(size_t count) {
+	_types.reserve(count);
+	_values.reserve(count);
+	_offsets.reserve(count);
+}
+
+
+void TokenBuffer::push(const Token& token, size_t offset, bool copyText) {
+	int32_t value = token.value();
+	if (token.type() == LexemType::str or token.type() == LexemType::error) {
+		value = static_cast<int32_t>(_texts.size());
+		if (copyText) {
+			_ownedTexts.emplace_back(token.str());
+			_texts.push_back(_ownedTexts.back());
+		}
+		else
+			_texts.push_back(token.str());
+	}
+
+	_types.push_back(static_cast<uint8_t>(token.type()));
+	_values.push_back(value);
+	_offsets.push_back(static_cast<uint32_t>(offset));
+}
+
+
+Token TokenBuffer::operator [] (size_t index) const {
+	if (index >= _types.size())
+		index = _types.size() - 1;
+
+	LexemType type = static_cast<LexemType>(_types[index]);
+	int32_t value = _values[index];
+	switch (type) {
+		case LexemType::num:
+			return Token(value);
+		case LexemType::chr:
+			return Token(static_cast<char>(value));
+		case LexemType::id:
+			return Token(type, _names[value], value);
+		case LexemType::str:
+		case LexemType::error:
+			return Token(type, _texts[value]);
+		default:
+			return Token(type);
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Interner.h"
+#include "Scanner.h"
+#include "Token.h"
+
+// Âåñü âõîä, çàðàíåå ðàçîáðàííûé íà ëåêñåìû è ðàçëîæåííûé ïî ïàðàëëåëüíûì ìàññèâàì.
+// Ïàðñåð õîäèò ïî íèì èíäåêñîì, ïîýòîìó çàãëÿíóòü íà k ëåêñåì âïåð¸ä ñòîèò O(1).
+class TokenBuffer {
+public:
+	TokenBuffer(const Interner& names) : _names{ names } {};
+
+	// Ïðî÷èòàòü èç ñêàíåðà âñå ëåêñåìû äî eof âêëþ÷èòåëüíî. Íåäîëãîâå÷íûå òåêñòû ñêàíåðà ïîòîêà êîïèðóþòñÿ
+	void fill(Scanner& scanner);
+	// Äîïèñàòü ëåêñåìû äðóãîãî áóôåðà áåç åãî eof (èëè ñ íèì, åñëè withEof).
+	// Íîìåðà èì¸í ïåðåâîäÿòñÿ ÷åðåç names (íîìåð â other -> íîìåð â ýòîì áóôåðå), ñìåùåíèÿ ñäâèãàþòñÿ íà offset
+	void append(const TokenBuffer& other, const std::vector<NameId>& names, size_t offset, bool withEof);
+	void reserve(size_t count);
+
+	size_t size() const { return _types.size(); };
+	LexemType type(size_t index) const { return static_cast<LexemType>(_types[index]); };
+	size_t offset(size_t index) const { return _offsets[index]; };
+	// Ëåêñåìà öåëèêîì; äëÿ èíäåêñîâ çà êîíöîì - ïîñëåäíÿÿ (eof)
+	Token operator [] (size_t index) const;
+
+private:
+	void push(const Token& token, size_t offset, bool copyText = false);
+
+	const Interner& _names;
+
+	// Òèï ëåêñåìû
+	std::vector<uint8_t> _types;
+	// Çíà÷åíèå num è chr, íîìåð èìåíè ó id, íîìåð òåêñòà â _texts ó str è error
+	std::vector<int32_t> _values;
+	// Ñìåùåíèå íà÷àëà ëåêñåìû âî âõîäå
+	std::vector<uint32_t> _offsets;
+	// Òåêñòû ñòðîê è ñîîáùåíèÿ îá îøèáêàõ
+	std::vector<std::string_view> _texts;
+	// Êîïèè òåêñòîâ, êîòîðûå ñêàíåð õðàíèò íåäîëãî (transientText)
+	std::deque<std::string> _ownedTexts;
+};
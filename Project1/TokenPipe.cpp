@@ -0,0 +1,54 @@
+#include <thread>
+
+#include "TokenPipe.h"
+
+
+void TokenPipe::run(Scanner& scanner) {
+	size_t position = 0;
+	size_t freed = 0;
+
+	while (true) {
+		// Áóôåð ïîëîí: îïóáëèêîâàòü çàïèñàííîå è æäàòü, ïîêà ÷èòàòåëü îñâîáîäèò ìåñòî
+		if (position - freed == Capacity) {
+			_written.store(position, std::memory_order_release);
+			while (position - (freed = _read.load(std::memory_order_acquire)) == Capacity) {
+				if (_cancelled.load(std::memory_order_relaxed))
+					return;
+				std::this_thread::yield();
+			}
+		}
+
+		Token token = scanner.getNextToken();
+		_slots[position & (Capacity - 1)] = token;
+		++position;
+
+		if (token.type() == LexemType::eof) {
+			_written.store(position, std::memory_order_release);
+			return;
+		}
+		if (position % Batch == 0)
+			_written.store(position, std::memory_order_release);
+	}
+}
+
+
+Token TokenPipe::pop() {
+	if (_finished)
+		return Token(LexemType::eof);
+
+	// Îïóáëèêîâàííûå ëåêñåìû êîí÷èëèñü: âåðíóòü ïèñàòåëþ ïðî÷èòàííîå è æäàòü ñëåäóþùóþ ïà÷êó
+	if (_readerPos == _readerLimit) {
+		_read.store(_readerPos, std::memory_order_release);
+		while ((_readerLimit = _written.load(std::memory_order_acquire)) == _readerPos)
+			std::this_thread::yield();
+	}
+
+	Token token = _slots[_readerPos & (Capacity - 1)];
+	++_readerPos;
+	if (_readerPos % Batch == 0)
+		_read.store(_readerPos, std::memory_order_release);
+
+	if (token.type() == LexemType::eof)
+		_finished = true;
+	return token;
+}
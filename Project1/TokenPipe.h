@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "Scanner.h"
+#include "Token.h"
+
+// Êîëüöåâîé áóôåð ëåêñåì ìåæäó ïîòîêîì ñêàíåðà (ïèñàòåëü) è ïàðñåðîì (÷èòàòåëü), áåç áëîêèðîâîê.
+// Îáå ñòîðîíû ñîîáùàþò î ñâîèõ ïîçèöèÿõ ïà÷êàìè ïî Batch ëåêñåì, à íå ïîñëå êàæäîé,
+// ïîýòîìó îáùèå ñ÷¸ò÷èêè ðåäêî ãîíÿþò êýø-ëèíèè ìåæäó ÿäðàìè.
+class TokenPipe {
+public:
+	static constexpr size_t Capacity = 4096;
+	static constexpr size_t Batch = 256;
+
+	TokenPipe() : _slots(new Token[Capacity]) {};
+
+	TokenPipe(const TokenPipe&) = delete;
+	TokenPipe& operator = (const TokenPipe&) = delete;
+
+	// Ïèñàòåëü: ïåðåëîæèòü âñå ëåêñåìû ñêàíåðà äî eof âêëþ÷èòåëüíî
+	void run(Scanner& scanner);
+	// Îñòàíîâèòü ïèñàòåëÿ, æäóùåãî ñâîáîäíîãî ìåñòà
+	void cancel() { _cancelled.store(true, std::memory_order_relaxed); };
+
+	// ×èòàòåëü: ñëåäóþùàÿ ëåêñåìà; ïîñëå eof - ñíîâà eof
+	Token pop();
+
+private:
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+	static_assert(Capacity % Batch == 0, "Capacity must be a multiple of Batch");
+	// Òåêñòû ëåêñåì â êîëüöå äîëæíû äîæèòü, ïîêà ïàðñåð äî íèõ äîéä¸ò
+	static_assert(Capacity + 2 <= Scanner::KeptLexemes, "Scanner::KeptLexemes must exceed Capacity");
+
+	std::unique_ptr<Token[]> _slots;
+
+	// Îïóáëèêîâàííûå ïîçèöèè: ñêîëüêî ëåêñåì çàïèñàíî è ñêîëüêî ïðî÷èòàíî
+	alignas(64) std::atomic<size_t> _written{ 0 };
+	alignas(64) std::atomic<size_t> _read{ 0 };
+	std::atomic<bool> _cancelled{ false };
+
+	// Ñîáñòâåííûå ñ÷¸ò÷èêè ÷èòàòåëÿ
+	alignas(64) size_t _readerPos = 0;
+	size_t _readerLimit = 0;
+	bool _finished = false;
+};
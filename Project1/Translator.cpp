@@ -1,16 +1,17 @@
+#include <algorithm>
 #include <exception>
 #include <iomanip>
 #include <memory>
 #include "Translator.h"
-#include "colors.h"
 
 
 void Translator::printAtoms(std::ostream& stream) {
-	for (auto& [scope, atom_vector] : _atoms) {
-		for (auto& atom : atom_vector) {
+	AtomWriter writer(_symbolTable, _stringTable);
+	for (Scope scope : _symbolTable.functions()) {
+		for (auto& atom : _atoms[_symbolTable[scope]._ordinal]) {
 			stream << std::setiosflags(std::ios::left) << std::setw(7);
 			stream << scope;
-			stream << atom->toString() << std::endl;
+			stream << writer.toString(atom) << std::endl;
 		}
 	}
 
@@ -20,14 +21,27 @@ void Translator::printAtoms(std::ostream& stream) {
 	stream << _stringTable;
 }
 
-void Translator::generateAtom(std::unique_ptr<Atom> atom, Scope scope) {
+void Translator::generateAtom(const Atom& atom, Scope scope) {
 	// Ïîëîæèòü â ñïèñîê àòîìîâ
 	// Íè÷åãî áîëüøå ïîðîæäàòü íå íàäî
-	_atoms[scope].push_back(std::move(atom));
+	_atoms[_symbolTable[scope]._ordinal].push_back(atom);
 }
 
-std::shared_ptr<LabelOperand> Translator::newLabel() {
-	return std::make_shared<LabelOperand>(_currentLabel++);
+size_t Translator::expectedAtoms() const {
+	// Ñðåäíèé ðàçìåð óæå ðàçîáðàííûõ ôóíêöèé, äëÿ ïåðâîé - îöåíêà ïî ðàçìåðó òåêñòà
+	if (_atomCount > 0)
+		return _atomCount / _atoms.size();
+	return std::min(_sourceSize / SourceBytesPerAtom, MaxFirstReserve);
+}
+
+Operand Translator::newLabel() {
+	return Operand::label(_currentLabel++);
+}
+
+Operand Translator::number(int value) {
+	if (value < Operand::MinNumber or value > Operand::MaxNumber)
+		lexicalError("×èñëî " + std::to_string(value) + " âíå äèàïàçîíà");
+	return Operand::number(value);
 }
 
 
@@ -42,7 +56,7 @@ void Translator::lexicalError(const std::string& message) {
 
 void Translator::lexCheck() {
 	if (_currentToken.type() == LexemType::error) {
-		lexicalError(_currentToken.str());
+		lexicalError(std::string(_currentToken.str()));
 	}
 }
 
@@ -52,232 +66,164 @@ void Translator::lexCheck() {
 
 
 
-std::shared_ptr<RValue> Translator::E(Scope scope) {
-	return Translator::E7(scope);
+Operand Translator::E(Scope scope) {
+	return BinaryExpr(scope, 1);
 }
 
-std::shared_ptr<RValue> Translator::E1(Scope scope) {
+Operand Translator::E1(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() == LexemType::num) {
-		auto q = std::make_shared<NumberOperand>(_currentToken.value());
-		_currentToken = _scanner.getNextToken();
+		auto q = number(_currentToken.value());
+		nextToken();
 		return q;
 	}
 	if (_currentToken.type() == LexemType::chr) {
-		auto q = std::make_shared<NumberOperand>(_currentToken.value());
-		_currentToken = _scanner.getNextToken();
+		auto q = number(_currentToken.value());
+		nextToken();
 		return q;
 	}
 
 	if (_currentToken.type() == LexemType::lpar) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		auto q = E(scope);
 		lexCheck();
 		if (_currentToken.type() != LexemType::rpar)
 			syntaxError(" íåò çàêðûâàþùåé êðóãëîé ñêîáêè.");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		return q;
 	}
 
 	if (_currentToken.type() == LexemType::opinc) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		lexCheck();
 		if (_currentToken.type() != LexemType::id) syntaxError(" îæèäàëàñü ïåðåìåííàÿ.");
-		auto q = _symbolTable.checkVar(scope, _currentToken.str());
+		auto q = _symbolTable.checkVar(scope, _currentToken.value());
 
-		if (q == nullptr)
+		if (!q)
 			syntaxError("Èñïîëüçîâàíèå íåîáúÿâëåííîé ïåðåìåííîé");
 
-		_currentToken = _scanner.getNextToken();
-		generateAtom(std::make_unique<SimpleBinaryOpAtom>("ADD", std::dynamic_pointer_cast<RValue>(q), one, q), scope);
+		nextToken();
+		generateAtom({ AtomOp::add, q, one, q }, scope);
 		return q;
 	}
 	if (_currentToken.type() == LexemType::id) {
-		std::string r = _currentToken.str();
-		_currentToken = _scanner.getNextToken();
+		NameId r = _currentToken.value();
+		nextToken();
 		auto s = E1_(r, scope);
 		return s;
 	}
 
 	if (_currentToken.type() == LexemType::opdec) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		lexCheck();
 		if (_currentToken.type() != LexemType::id) syntaxError(" îæèäàëàñü ïåðåìåííàÿ.");
-		auto q = _symbolTable.checkVar(scope, _currentToken.str());
+		auto q = _symbolTable.checkVar(scope, _currentToken.value());
 
-		if (q == nullptr)
+		if (!q)
 			syntaxError("Èñïîëüçîâàíèå íåîáúÿâëåííîé ïåðåìåííîé");
 
-		_currentToken = _scanner.getNextToken();
-		generateAtom(std::make_unique<SimpleBinaryOpAtom>("SUB", std::dynamic_pointer_cast<RValue>(q), one, q), scope);
+		nextToken();
+		generateAtom({ AtomOp::sub, q, one, q }, scope);
 		return q;
 	}
 
 	syntaxError(" îæèäàëñÿ îïåðàíä.");
 }
 
-std::shared_ptr<RValue> Translator::E1_(std::string name, Scope scope) {
+Operand Translator::E1_(NameId name, Scope scope) {
 	lexCheck();
 	if (_currentToken.type() == LexemType::opinc) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		auto p = _symbolTable.checkVar(scope, name);
 
-		if (p == nullptr)
+		if (!p)
 			syntaxError("Èñïîëüçîâàíèå íåîáúÿâëåííîé ïåðåìåííîé");
 
 		auto r = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<UnaryOpAtom>("MOV", p, r), scope);
-		generateAtom(std::make_unique<SimpleBinaryOpAtom>("ADD", p, one, std::dynamic_pointer_cast<MemoryOperand>(p)), scope);
+		generateAtom({ AtomOp::mov, p, {}, r }, scope);
+		generateAtom({ AtomOp::add, p, one, p }, scope);
 		return r;
 	}
 	if (_currentToken.type() == LexemType::lpar) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		int count_args = ArgList(scope);
 		lexCheck();
 		if (_currentToken.type() != LexemType::rpar) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		auto s = _symbolTable.checkFunc(name, count_args);
 
-		if (s == nullptr)
-			syntaxError("Íå íàéäåíà ôóíêöèÿ ñ èìåíåì <" + name + "> ñ êîëè÷åñòâîì ïàðàìåòðîâ " + std::to_string(count_args));
+		if (!s)
+			syntaxError("Íå íàéäåíà ôóíêöèÿ ñ èìåíåì <" + std::string(nameText(name)) + "> ñ êîëè÷åñòâîì ïàðàìåòðîâ " + std::to_string(count_args));
 
 		auto r = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<CallAtom>(s, r), scope);
+		generateAtom({ AtomOp::call, s, {}, r }, scope);
 		return r;
 	}
 	
 	if (_currentToken.type() == LexemType::opdec) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		auto p = _symbolTable.checkVar(scope, name);
 
-		if (p == nullptr)
+		if (!p)
 			syntaxError("Èñïîëüçîâàíèå íåîáúÿâëåííîé ïåðåìåííîé");
 
 		auto r = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<UnaryOpAtom>("MOV", p, r), scope);
-		generateAtom(std::make_unique<SimpleBinaryOpAtom>("SUB", p, one, std::dynamic_pointer_cast<MemoryOperand>(p)), scope);
+		generateAtom({ AtomOp::mov, p, {}, r }, scope);
+		generateAtom({ AtomOp::sub, p, one, p }, scope);
 		return r;
 	}
 
 	auto p = _symbolTable.checkVar(scope, name);
 
-	if (p == nullptr)
+	if (!p)
 		syntaxError("Èñïîëüçîâàíèå íåîáúÿâëåííîé ïåðåìåííîé");
 
 	return p;
 }
 
 
-std::shared_ptr<RValue> Translator::E2(Scope scope) {
+Operand Translator::E2(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() == LexemType::opnot) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		auto q = E1(scope);
 		auto r = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<UnaryOpAtom>("NOT", q, r), scope);
+		generateAtom({ AtomOp::opnot, q, {}, r }, scope);
 		return r;
 	}
 	return E1(scope);
 }
 
-std::shared_ptr<RValue> Translator::E3(Scope scope) {
-	return E3_(E2(scope), scope);
-}
-
-std::shared_ptr<RValue> Translator::E3_(std::shared_ptr<RValue> p, Scope scope) {
-	lexCheck();
-	if (_currentToken.type() == LexemType::opmult) {
-		_currentToken = _scanner.getNextToken();
-		auto r = E2(scope);
-		auto s = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<FnBinaryOpAtom>("MUL", p, r, s), scope);
-		return E3_(s, scope);
-	}
-	return p;
-}
-
-std::shared_ptr<RValue> Translator::E4(Scope scope) {
-	return E4_(E3(scope), scope);
-}
+Operand Translator::BinaryExpr(Scope scope, int minPower) {
+	auto p = E2(scope);
+	// Ñèëà ïîñëåäíåé îïåðàöèè, ðåçóëüòàòîì êîòîðîé ñòàë p: çà ñðàâíåíèåì èëè îïåðàöèåé
+	// ñëàáåå ñðàâíåíèÿ äðóãîå ñðàâíåíèå íå ñòàâèòñÿ
+	int pPower = MaxBindingPower;
 
-std::shared_ptr<RValue> Translator::E4_(std::shared_ptr<RValue> p, Scope scope) {
-	lexCheck();
-	if (_currentToken.type() == LexemType::opplus) {
-		_currentToken = _scanner.getNextToken();
-		auto r = E3(scope);
-		auto s = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<SimpleBinaryOpAtom>("ADD", p, r, s), scope);
-		return E4_(s, scope);
-	}
-	if (_currentToken.type() == LexemType::opminus) {
-		_currentToken = _scanner.getNextToken();
-		auto r = E3(scope);
-		auto s = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<SimpleBinaryOpAtom>("SUB", p, r, s), scope);
-		return E4_(s, scope);
-	}
-	return p;
-}
-
-std::shared_ptr<RValue> Translator::E5(Scope scope) {
-	return E5_(E4(scope), scope);
-}
-
-std::shared_ptr<RValue> Translator::E5_(std::shared_ptr<RValue> p, Scope scope) {
-	lexCheck();
-	LexemType type = _currentToken.type();
-	if (type == LexemType::opeq ||
-		type == LexemType::opne ||
-		type == LexemType::opgt ||
-		type == LexemType::oplt ||
-		type == LexemType::ople)
-	{
-		_currentToken = _scanner.getNextToken();
-		auto r = E4(scope);
+	while (true) {
+		lexCheck();
+		const BinaryOperator& op = binaryOperators[static_cast<size_t>(_currentToken.type())];
+		if (op.power == 0 or op.power < minPower)
+			return p;
+		if (isComparison(op.form) and pPower <= op.power)
+			return p;
+		nextToken();
+
+		auto r = BinaryExpr(scope, op.power + 1);
 		auto s = _symbolTable.alloc(scope);
-		auto l = newLabel();
-		generateAtom(std::make_unique<UnaryOpAtom>("MOV", one, s), scope);
-		if (type != LexemType::ople)
-			generateAtom(std::make_unique<SimpleConditionalJumpAtom>(simple_jumps[type], p, r, l), scope);
+		if (isComparison(op.form)) {
+			auto l = newLabel();
+			generateAtom({ AtomOp::mov, one, {}, s }, scope);
+			generateAtom({ op.op, p, r, l }, scope);
+			generateAtom({ AtomOp::mov, zero, {}, s }, scope);
+			generateAtom({ AtomOp::label, {}, {}, l }, scope);
+		}
 		else
-			generateAtom(std::make_unique<ComplexConditionalJumpAtom>("LE", p, r, l), scope);
-		generateAtom(std::make_unique<UnaryOpAtom>("MOV", zero, s), scope);
-		generateAtom(std::make_unique<LabelAtom>(l), scope);
-		return s;
-	}
-	return p;
-}
+			generateAtom({ op.op, p, r, s }, scope);
 
-std::shared_ptr<RValue> Translator::E6(Scope scope) {
-	return E6_(E5(scope), scope);
-}
-
-std::shared_ptr<RValue> Translator::E6_(std::shared_ptr<RValue> p, Scope scope) {
-	lexCheck();
-	if (_currentToken.type() == LexemType::opand) {
-		_currentToken = _scanner.getNextToken();
-		auto r = E5(scope);
-		auto s = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<SimpleBinaryOpAtom>("AND", p, r, s), scope);
-		return E6_(s, scope);
-	}
-	return p;
-}
-
-std::shared_ptr<RValue> Translator::E7(Scope scope) {
-	return E7_(E6(scope), scope);
-}
-
-std::shared_ptr<RValue> Translator::E7_(std::shared_ptr<RValue> p, Scope scope) {
-	lexCheck();
-	if (_currentToken.type() == LexemType::opor) {
-		_currentToken = _scanner.getNextToken();
-		auto r = E6(scope);
-		auto s = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<SimpleBinaryOpAtom>("OR", p, r, s), scope);
-		return E7_(s, scope);
+		p = s;
+		pPower = op.power;
 	}
-	return p;
 }
 
 
@@ -290,8 +236,8 @@ void Translator::DeclareStmt(Scope scope) {
 	auto q = Type(scope);
 	lexCheck();
 	if (_currentToken.type() == LexemType::id) {
-		auto r = _currentToken.str();
-		_currentToken = _scanner.getNextToken();
+		NameId r = _currentToken.value();
+		nextToken();
 		DeclareStmt_(q, r, scope);
 	}
 }
@@ -300,26 +246,34 @@ void Translator::DeclareStmt(Scope scope) {
 SymbolTable::TableRecord::RecordType Translator::Type(Scope) {
 	lexCheck();
 	if (_currentToken.type() == LexemType::kwchar) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		return SymbolTable::TableRecord::RecordType::chr;
 	}
 	else if (_currentToken.type() == LexemType::kwint) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		return SymbolTable::TableRecord::RecordType::integer;
 	}
 	syntaxError("Îæèäàëñÿ òèï");
 }
 
-void Translator::DeclareStmt_(SymbolTable::TableRecord::RecordType type, std::string name, Scope scope) {
+void Translator::DeclareStmt_(SymbolTable::TableRecord::RecordType type, NameId name, Scope scope) {
 	lexCheck();
 	if (_currentToken.type() == LexemType::lpar) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 		if (scope > -1) {
 			syntaxError("function definition inside function");
 		}
 		else {
-			scope = (_symbolTable.addFunc(name, type, -1))->index();
+			auto func = _symbolTable.addFunc(name, type, -1);
+			if (!func)
+				syntaxError("Èìÿ ôóíêöèè <" + std::string(nameText(name)) + "> óæå îáúÿâëåíî");
+			scope = func.value();
+
+			// Ñïèñîê àòîìîâ ïîä ïîðÿäêîâûé íîìåð íîâîé ôóíêöèè
+			size_t reserve = expectedAtoms();
+			_atoms.emplace_back();
+			_atoms.back().reserve(reserve);
 		}
 
 		int n = ParamList(scope);
@@ -328,24 +282,24 @@ void Translator::DeclareStmt_(SymbolTable::TableRecord::RecordType type, std::st
 		lexCheck();
 
 		if (_currentToken.type() != LexemType::rpar) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 		if (_currentToken.type() == LexemType::lbrace) {
-			_currentToken = _scanner.getNextToken();
+			nextToken();
 			StmtList(scope);
 			lexCheck();
 			if (_currentToken.type() != LexemType::rbrace) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ ôèãóðíàÿ ñêîáêà");
-			_currentToken = _scanner.getNextToken();
+			nextToken();
 		}
-		auto zero = std::make_shared<NumberOperand>(0);
-		generateAtom(std::make_unique<RetAtom>(zero), scope);
+		generateAtom({ AtomOp::ret, {}, {}, zero }, scope);
+		endFunction(scope);
 	}
 	else if (_currentToken.type() == LexemType::opassign) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		lexCheck();
 		if (_currentToken.type() == LexemType::num or _currentToken.type() == LexemType::chr) {
 			auto val = _currentToken.value();
-			_currentToken = _scanner.getNextToken();
+			nextToken();
 
 			_symbolTable.addVar(name, scope, type, val);
 
@@ -353,7 +307,7 @@ void Translator::DeclareStmt_(SymbolTable::TableRecord::RecordType type, std::st
 
 			lexCheck();
 			if (_currentToken.type() != LexemType::semicolon) syntaxError("Îæèäàëàñü òî÷êà ñ çàïÿòîé");
-			_currentToken = _scanner.getNextToken();
+			nextToken();
 		}
 	}
 	else {
@@ -361,7 +315,7 @@ void Translator::DeclareStmt_(SymbolTable::TableRecord::RecordType type, std::st
 		DeclVarList_(type, scope);
 		lexCheck();
 		if (_currentToken.type() != LexemType::semicolon) syntaxError("Îæèäàëàñü òî÷êà ñ çàïÿòîé");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 	}
 
 	
@@ -369,27 +323,27 @@ void Translator::DeclareStmt_(SymbolTable::TableRecord::RecordType type, std::st
 
 void Translator::DeclVarList_(SymbolTable::TableRecord::RecordType type, Scope scope) {
 	lexCheck();
-	if (_currentToken.type() == LexemType::comma) {
-		_currentToken = _scanner.getNextToken();
+	while (_currentToken.type() == LexemType::comma) {
+		nextToken();
 
 		lexCheck();
 		if (_currentToken.type() != LexemType::id) syntaxError("Îæèäàëîñü íàçâàíèå ïåðåìåííîé");
 
-		auto name = _currentToken.str();
-		_currentToken = _scanner.getNextToken();
+		NameId name = _currentToken.value();
+		nextToken();
 		
 		InitVar(type, name, scope);
-		DeclVarList_(type, scope);
+		lexCheck();
 	}
 }
 
 
-void Translator::InitVar(SymbolTable::TableRecord::RecordType type, std::string name, Scope scope) {
+void Translator::InitVar(SymbolTable::TableRecord::RecordType type, NameId name, Scope scope) {
 	lexCheck();
 	if (_currentToken.type() == LexemType::chr or _currentToken.type() == LexemType::num) {
 		auto val = _currentToken.value();
 		_symbolTable.addVar(name, scope, type, val);
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 	}
 	else {
 		_symbolTable.addVar(name, scope, type);
@@ -398,11 +352,13 @@ void Translator::InitVar(SymbolTable::TableRecord::RecordType type, std::string
 
 
 void Translator::StmtList(Scope scope) {
-	if (_currentToken.type() == LexemType::eof) return;
-	if (_currentToken.type() == LexemType::rbrace) return;
-	if (_currentToken.type() == LexemType::kwcase || _currentToken.type() == LexemType::kwdefault) return;
-	Stmt(scope);
-	StmtList(scope);
+	// Ãëóáèíó ñòåêà îãðàíè÷èâàåò âëîæåííîñòü îïåðàòîðîâ, à íå èõ ÷èñëî
+	while (true) {
+		if (_currentToken.type() == LexemType::eof) return;
+		if (_currentToken.type() == LexemType::rbrace) return;
+		if (_currentToken.type() == LexemType::kwcase || _currentToken.type() == LexemType::kwdefault) return;
+		Stmt(scope);
+	}
 }
 
 void Translator::Stmt(Scope scope) {
@@ -416,12 +372,12 @@ void Translator::Stmt(Scope scope) {
 	if (scope == -1) syntaxError("operator should be inside function");
 
 	if (_currentToken.type() == LexemType::lbrace) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		StmtList(scope);
 
 		lexCheck();
 		if (_currentToken.type() != LexemType::rbrace) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ ôèãóðíàÿ ñêîáêà");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 		return;
 	}
@@ -455,12 +411,12 @@ void Translator::Stmt(Scope scope) {
 	}
 
 	if (_currentToken.type() == LexemType::kwreturn) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		auto p = E(scope);
-		generateAtom(std::make_unique<RetAtom>(p), scope);
+		generateAtom({ AtomOp::ret, {}, {}, p }, scope);
 
 		if (_currentToken.type() != LexemType::semicolon) syntaxError("Îæèäàëàñü òî÷êà ñ çàïÿòîé");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 		return;
 	}
@@ -476,8 +432,8 @@ int Translator::ParamList(Scope scope) {
 	auto type = Type(scope);
 	lexCheck();
 	if (_currentToken.type() != LexemType::id) syntaxError("Îæèäàëîñü èìÿ ïàðàìåòðà");
-	std::string name = _currentToken.str();
-	_currentToken = _scanner.getNextToken();
+	NameId name = _currentToken.value();
+	nextToken();
 
 	_symbolTable.addVar(name, scope, type, 0, is_const);
 
@@ -485,30 +441,31 @@ int Translator::ParamList(Scope scope) {
 }
 
 int Translator::ParamList_(Scope scope) {
-	if (_currentToken.type() == LexemType::rpar) return 0;
-
-	lexCheck();
-	if (_currentToken.type() != LexemType::comma) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ ñêîáêà èëè åù¸ îäèí ïàðàìåòð");
-	_currentToken = _scanner.getNextToken();
-
-	bool is_const = IsConst(scope);
+	int count = 0;
+	while (_currentToken.type() != LexemType::rpar) {
+		lexCheck();
+		if (_currentToken.type() != LexemType::comma) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ ñêîáêà èëè åù¸ îäèí ïàðàìåòð");
+		nextToken();
 
-	auto type = Type(scope);
-	lexCheck();
-	if (_currentToken.type() != LexemType::id) syntaxError("Îæèäàëîñü èìÿ ïàðàìåòðà");
-	std::string name = _currentToken.str();
-	_currentToken = _scanner.getNextToken();
+		bool is_const = IsConst(scope);
 
-	_symbolTable.addVar(name, scope, type, 0, is_const);
+		auto type = Type(scope);
+		lexCheck();
+		if (_currentToken.type() != LexemType::id) syntaxError("Îæèäàëîñü èìÿ ïàðàìåòðà");
+		NameId name = _currentToken.value();
+		nextToken();
 
-	return ParamList_(scope) + 1;
+		_symbolTable.addVar(name, scope, type, 0, is_const);
+		++count;
+	}
+	return count;
 }
 
 bool Translator::IsConst(Scope scope) {
 	lexCheck();
 
 	if (_currentToken.type() == LexemType::kwconst) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		return true;
 	}
 
@@ -522,50 +479,50 @@ void Translator::AssignOrCallOp(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() != LexemType::semicolon)
 		syntaxError("Îæèäàëàñü òî÷êà ñ çàïÿòîé");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 }
 
 void Translator::AssignOrCall(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() != LexemType::id) syntaxError("Íåèçâåñòíàÿ îøèáêà");
 
-	std::string name = _currentToken.str();
-	_currentToken = _scanner.getNextToken();
+	NameId name = _currentToken.value();
+	nextToken();
 	AssignOrCall_(scope, name);
 }
 
-void Translator::AssignOrCall_(Scope scope, std::string name) {
+void Translator::AssignOrCall_(Scope scope, NameId name) {
 	lexCheck();
 
 	if (_currentToken.type() == LexemType::lpar) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		int n = ArgList(scope);
 
 		lexCheck();
 		if (_currentToken.type() != LexemType::rpar) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 		auto q = _symbolTable.checkFunc(name, n);
 
-		if (q == nullptr)
-			syntaxError("Íå íàéäåíà ôóíêöèÿ ñ èìåíåì <" + name + "> ñ êîëè÷åñòâîì ïàðàìåòðîâ " + std::to_string(n));
+		if (!q)
+			syntaxError("Íå íàéäåíà ôóíêöèÿ ñ èìåíåì <" + std::string(nameText(name)) + "> ñ êîëè÷åñòâîì ïàðàìåòðîâ " + std::to_string(n));
 
 		auto r = _symbolTable.alloc(scope);
-		generateAtom(std::make_unique<CallAtom>(q, r), scope);
+		generateAtom({ AtomOp::call, q, {}, r }, scope);
 	}
 	else if (_currentToken.type() == LexemType::opassign) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		auto q = E(scope);
 		auto r = _symbolTable.checkVar(scope, name);
 
-		if (r == nullptr)
+		if (!r)
 			syntaxError("Èñïîëüçîâàíèå íåîáúÿâëåííîé ïåðåìåííîé");
-		if ((r->_symbolTable)->operator[](r->_index)._is_const) {
+		if (_symbolTable.isConst(r.value())) {
 			syntaxError("Íåëüçÿ èçìåíÿòü êîíñòàíòíóþ ïåðåìåííóþ.");
 		}
 
 
-		generateAtom(std::make_unique<UnaryOpAtom>("MOV", q, r), scope);
+		generateAtom({ AtomOp::mov, q, {}, r }, scope);
 	}
 	else {
 		syntaxError("îæèäàëîñü ïðèñâîåíèå èëè âûçîâ ôóíêöèè");
@@ -581,18 +538,21 @@ int Translator::ArgList(Scope scope) {
 		_currentToken.type() == LexemType::opnot or
 		_currentToken.type() == LexemType::opinc) 
 	{
-		auto p = E(scope);
-		int n = ArgList_(scope) + 1;
-		generateAtom(std::make_unique<ParamAtom>(p), scope);
-		return n;
+		std::vector<Operand> args{ E(scope) };
+		ArgList_(scope, args);
+
+		// Ñíà÷àëà âû÷èñëÿþòñÿ âñå àðãóìåíòû, çàòåì îíè ïåðåäàþòñÿ ñ ïîñëåäíåãî
+		for (auto arg = args.rbegin(); arg != args.rend(); ++arg)
+			generateAtom({ AtomOp::param, {}, {}, *arg }, scope);
+		return static_cast<int>(args.size());
 	}
 	return 0;
 }
 
-int Translator::ArgList_(Scope scope) {
+void Translator::ArgList_(Scope scope, std::vector<Operand>& args) {
 	lexCheck();
-	if (_currentToken.type() == LexemType::comma) {
-		_currentToken = _scanner.getNextToken();
+	while (_currentToken.type() == LexemType::comma) {
+		nextToken();
 
 		if (_currentToken.type() == LexemType::id or
 			_currentToken.type() == LexemType::num or
@@ -601,16 +561,13 @@ int Translator::ArgList_(Scope scope) {
 			_currentToken.type() == LexemType::opnot or
 			_currentToken.type() == LexemType::opinc)
 		{
-			auto p = E(scope);
-			int n = ArgList_(scope) + 1;
-			generateAtom(std::make_unique<ParamAtom>(p), scope);
-			return n;
+			args.push_back(E(scope));
 		}
 		else {
 			syntaxError("Îæèäàëñÿ åù¸ ïàðàìåòð");
 		}
+		lexCheck();
 	}
-	return 0;
 }
 
 
@@ -620,37 +577,37 @@ int Translator::ArgList_(Scope scope) {
 void Translator::IfOp(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() != LexemType::kwif) syntaxError("Íåèçâåñòíàÿ îøèáêà â IF");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	lexCheck();
 	if (_currentToken.type() != LexemType::lpar) syntaxError("Îæèäàëàñü îòêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	auto p = E(scope);
 
 	lexCheck();
 	if (_currentToken.type() != LexemType::rpar) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	auto l1 = newLabel();
 	auto l2 = newLabel();
 
-	generateAtom(std::make_unique<SimpleConditionalJumpAtom>("EQ", p, zero, l1), scope);
+	generateAtom({ AtomOp::eq, p, zero, l1 }, scope);
 
 	Stmt(scope);
 
-	generateAtom(std::make_unique<JumpAtom>(l2), scope);
-	generateAtom(std::make_unique<LabelAtom>(l1), scope);
+	generateAtom({ AtomOp::jmp, {}, {}, l2 }, scope);
+	generateAtom({ AtomOp::label, {}, {}, l1 }, scope);
 
 	ElsePart(scope);
 
-	generateAtom(std::make_unique<LabelAtom>(l2), scope);
+	generateAtom({ AtomOp::label, {}, {}, l2 }, scope);
 }
 
 void Translator::ElsePart(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() == LexemType::kwelse) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 		Stmt(scope);
 	}
 }
@@ -659,23 +616,23 @@ void Translator::ElsePart(Scope scope) {
 void Translator::IOp(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() != LexemType::kwin) syntaxError("Íåèçâåñòíàÿ îøèáêà â IN");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	lexCheck();
 	if (_currentToken.type() == LexemType::id) {
-		std::string name = _currentToken.str();
-		_currentToken = _scanner.getNextToken();
+		NameId name = _currentToken.value();
+		nextToken();
 
 		auto p = _symbolTable.checkVar(scope, name);
 
-		if (p == nullptr)
+		if (!p)
 			syntaxError("Èñïîëüçîâàíèå íåîáúÿâëåííîé ïåðåìåííîé");
 
 		lexCheck();
 		if (_currentToken.type() != LexemType::semicolon) syntaxError("Îæèäàëàñü òî÷êà ñ çàïÿòîé");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
-		generateAtom(std::make_unique<InAtom>(p), scope);
+		generateAtom({ AtomOp::in, {}, {}, p }, scope);
 	}
 	else {
 		syntaxError("Îæèäàëñÿ èäåíòèôèêàòîð");
@@ -685,99 +642,100 @@ void Translator::IOp(Scope scope) {
 void Translator::OOp(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() != LexemType::kwout) syntaxError("Íåèçâåñòíàÿ îøèáêà â OUT");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	OOp_(scope);
 
 	lexCheck();
 	if (_currentToken.type() != LexemType::semicolon) syntaxError("Îæèäàëàñü òî÷êà ñ çàïÿòîé");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 }
 
 void Translator::OOp_(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() == LexemType::str){
-		auto s = _stringTable.add(_currentToken.str());
-		_currentToken = _scanner.getNextToken();
+		auto text = _currentToken.str();
+		auto s = _sharedStrings != nullptr ? Operand::string(_sharedStrings->intern(text, _stringOrder++)) : _stringTable.add(text);
+		nextToken();
 
-		generateAtom(std::make_unique<OutAtom>(s), scope);
+		generateAtom({ AtomOp::out, {}, {}, s }, scope);
 	}
 	else {
 		auto p = E(scope);
-		generateAtom(std::make_unique<OutAtom>(p), scope);
+		generateAtom({ AtomOp::out, {}, {}, p }, scope);
 	}
 }
 
 void Translator::WhileOp(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() != LexemType::kwwhile) syntaxError("Íàèçâåñòíàÿ îøèáêà â WHILE");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	auto l1 = newLabel();
-	generateAtom(std::make_unique<LabelAtom>(l1), scope);
+	generateAtom({ AtomOp::label, {}, {}, l1 }, scope);
 
 	lexCheck();
 	if (_currentToken.type() != LexemType::lpar) syntaxError("Îæèäàëàñü îòêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	auto p = E(scope);
 
 	if (_currentToken.type() != LexemType::rpar) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	auto l2 = newLabel();
-	generateAtom(std::make_unique<SimpleConditionalJumpAtom>("EQ", p, zero, l2), scope);
+	generateAtom({ AtomOp::eq, p, zero, l2 }, scope);
 
 	Stmt(scope);
 
-	generateAtom(std::make_unique<JumpAtom>(l1), scope);
-	generateAtom(std::make_unique<LabelAtom>(l2), scope);
+	generateAtom({ AtomOp::jmp, {}, {}, l1 }, scope);
+	generateAtom({ AtomOp::label, {}, {}, l2 }, scope);
 }
 
 void Translator::ForOp(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() != LexemType::kwfor) syntaxError("Íåèçâåñòíàÿ îøèáêà â FOR");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	lexCheck();
 	if (_currentToken.type() != LexemType::lpar) syntaxError("Îæèäàëàñü îòêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	ForInit(scope);
 
 
 	auto l1 = newLabel();
-	generateAtom(std::make_unique<LabelAtom>(l1), scope);
+	generateAtom({ AtomOp::label, {}, {}, l1 }, scope);
 
 	auto p = ForExpr(scope);
 
 	lexCheck();
 	if (_currentToken.type() != LexemType::semicolon) syntaxError("Îæèäàëàñü òî÷êà ñ çàïÿòîé");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	auto l2 = newLabel();
 	auto l3 = newLabel();
 	auto l4 = newLabel();
 
-	generateAtom(std::make_unique<SimpleConditionalJumpAtom>("EQ", p, zero, l4), scope);
-	generateAtom(std::make_unique<JumpAtom>(l3), scope);
-	generateAtom(std::make_unique<LabelAtom>(l2), scope);
+	generateAtom({ AtomOp::eq, p, zero, l4 }, scope);
+	generateAtom({ AtomOp::jmp, {}, {}, l3 }, scope);
+	generateAtom({ AtomOp::label, {}, {}, l2 }, scope);
 
 	ForLoop(scope);
 
-	generateAtom(std::make_unique<JumpAtom>(l1), scope);
+	generateAtom({ AtomOp::jmp, {}, {}, l1 }, scope);
 
 	lexCheck();
 	if (_currentToken.type() != LexemType::rpar) syntaxError("Îæèäàëàñü çàêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 
-	generateAtom(std::make_unique<LabelAtom>(l3), scope);
+	generateAtom({ AtomOp::label, {}, {}, l3 }, scope);
 
 	Stmt(scope);
 
-	generateAtom(std::make_unique<JumpAtom>(l2), scope);
-	generateAtom(std::make_unique<LabelAtom>(l4), scope);
+	generateAtom({ AtomOp::jmp, {}, {}, l2 }, scope);
+	generateAtom({ AtomOp::label, {}, {}, l4 }, scope);
 }
 
 void Translator::ForInit(Scope scope) {
@@ -785,11 +743,11 @@ void Translator::ForInit(Scope scope) {
 		AssignOrCallOp(scope);
 	}
 	else if (_currentToken.type() == LexemType::semicolon) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 	}
 }
 
-std::shared_ptr<RValue> Translator::ForExpr(Scope scope) {
+Operand Translator::ForExpr(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() == LexemType::semicolon) {
 		return one;
@@ -805,18 +763,18 @@ void Translator::ForLoop(Scope scope) {
 		AssignOrCall(scope);
 	}
 	else if (_currentToken.type() == LexemType::opinc) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 		if (_currentToken.type() != LexemType::id) syntaxError("Îæèäàëñÿ èäåíòèôèêàòîð");
 
-		auto p = _symbolTable.checkVar(scope, _currentToken.str());
+		auto p = _symbolTable.checkVar(scope, _currentToken.value());
 
-		if (p == nullptr)
+		if (!p)
 			syntaxError("Èñïîëüçîâàíèå íåîáúÿâëåííîé ïåðåìåííîé");
 
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
-		generateAtom(std::make_unique<SimpleBinaryOpAtom>("ADD", p, one, p), scope);
+		generateAtom({ AtomOp::add, p, one, p }, scope);
 	}
 }
 
@@ -824,23 +782,23 @@ void Translator::ForLoop(Scope scope) {
 void Translator::SwitchOp(Scope scope) {
 	lexCheck();
 	if (_currentToken.type() != LexemType::kwswitch) syntaxError("Íåèçâåñòíàÿ îøèáêà â SWITCH");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	lexCheck();
 	if (_currentToken.type() != LexemType::lpar)
 		syntaxError("Îæèäàëàñü îòêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	auto p = E(scope);
 
 	lexCheck();
 	if (_currentToken.type() != LexemType::rpar)
 		syntaxError("Îæèäàëàñü çàêðûâàþùàÿ êðóãëàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	if (_currentToken.type() != LexemType::lbrace)
 		syntaxError("Îæèäàëàñü îòêðûâàþùàÿ ôèãóðíàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
 	auto l1 = newLabel();
 
@@ -848,13 +806,13 @@ void Translator::SwitchOp(Scope scope) {
 
 	if (_currentToken.type() != LexemType::rbrace)
 		syntaxError("Îæèäàëàñü çàêðûâàþùàÿ ôèãóðíàÿ ñêîáêà");
-	_currentToken = _scanner.getNextToken();
+	nextToken();
 
-	generateAtom(std::make_unique<LabelAtom>(l1), scope);
+	generateAtom({ AtomOp::label, {}, {}, l1 }, scope);
 }
 
 
-void Translator::Cases(Scope scope, std::shared_ptr<RValue> p, std::shared_ptr<LabelOperand> end) {
+void Translator::Cases(Scope scope, Operand p, Operand end) {
 	
 	lexCheck();
 	if (_currentToken.type() == LexemType::kwcase || _currentToken.type() == LexemType::kwdefault) {
@@ -868,56 +826,56 @@ void Translator::Cases(Scope scope, std::shared_ptr<RValue> p, std::shared_ptr<L
 
 
 
-std::shared_ptr<LabelOperand> Translator::ACase(Scope scope, std::shared_ptr<RValue> p, std::shared_ptr<LabelOperand> end) {
+Operand Translator::ACase(Scope scope, Operand p, Operand end) {
 
 	if (_currentToken.type() == LexemType::kwcase) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 		lexCheck();
 		if (_currentToken.type() != LexemType::num)
 			syntaxError("Îæèäàëñÿ NUM");
 		
 		int val = _currentToken.value();
-		auto v = std::make_shared<NumberOperand>(val);
-		_currentToken = _scanner.getNextToken();
+		auto v = number(val);
+		nextToken();
 
 		auto next = newLabel();
 
-		generateAtom(std::make_unique<SimpleConditionalJumpAtom>("NE", p, v, next), scope);
+		generateAtom({ AtomOp::ne, p, v, next }, scope);
 
 		lexCheck();
 		if (_currentToken.type() != LexemType::colon)
 			syntaxError("Îæèäàëîñü Äâîåòî÷èå");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 		StmtList(scope);
 
-		generateAtom(std::make_unique<JumpAtom>(end), scope);
-		generateAtom(std::make_unique<LabelAtom>(next), scope);
+		generateAtom({ AtomOp::jmp, {}, {}, end }, scope);
+		generateAtom({ AtomOp::label, {}, {}, next }, scope);
 
 
-		return nullptr;
+		return {};
 	}
 
 	if (_currentToken.type() == LexemType::kwdefault) {
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 		auto next = newLabel();
 		auto def = newLabel();
 		lexCheck();
 		if (_currentToken.type() != LexemType::colon)
 			syntaxError("Îæèäàëîñü Äâîåòî÷èå");
-		_currentToken = _scanner.getNextToken();
+		nextToken();
 
 
-		generateAtom(std::make_unique<JumpAtom>(next), scope);
-		generateAtom(std::make_unique<LabelAtom>(def), scope);
+		generateAtom({ AtomOp::jmp, {}, {}, next }, scope);
+		generateAtom({ AtomOp::label, {}, {}, def }, scope);
 
 
 		StmtList(scope);
 
-		generateAtom(std::make_unique<JumpAtom>(end), scope);
-		generateAtom(std::make_unique<LabelAtom>(next), scope);
+		generateAtom({ AtomOp::jmp, {}, {}, end }, scope);
+		generateAtom({ AtomOp::label, {}, {}, next }, scope);
 
 
 		return def;
@@ -925,32 +883,28 @@ std::shared_ptr<LabelOperand> Translator::ACase(Scope scope, std::shared_ptr<RVa
 }
 
 
-void Translator::Cases_(Scope scope, std::shared_ptr<RValue> p, std::shared_ptr<LabelOperand> end, std::shared_ptr<LabelOperand> def) {
-	lexCheck();
-	if (_currentToken.type() == LexemType::rbrace) {
-		std::shared_ptr<LabelOperand> q;
-		if (def != nullptr) {
-			q = def;
-		}
-		else {
-			q = end;
+void Translator::Cases_(Scope scope, Operand p, Operand end, Operand def) {
+	while (true) {
+		lexCheck();
+		if (_currentToken.type() == LexemType::rbrace) {
+			Operand q;
+			if (def) {
+				q = def;
+			}
+			else {
+				q = end;
+			}
+
+			generateAtom({ AtomOp::jmp, {}, {}, q }, scope);
+			return;
 		}
 
-		generateAtom(std::make_unique<JumpAtom>(q), scope);
-	}
-	else {
 		auto def1 = ACase(scope, p, end);
-		std::shared_ptr<LabelOperand> def2;
-		if (def != nullptr and def1 != nullptr) {
+		if (def and def1) {
 			syntaxError("SYNTAX ERROR: two default sect.");
 		}
-		else {
-			if (def != nullptr)
-				def2 = def;
-			else if (def1 != nullptr)
-				def2 = def1;
-		}
-		Cases_(scope, p, end, def2);
+		if (!def)
+			def = def1;
 	}
 }
 
@@ -982,129 +936,137 @@ void Translator::generateProlog(std::ostream& stream) {
 	stream << "; Code for PRINT library function" << '\n';
 }
 
-void Translator::generateFunction(std::ostream& stream, std::string function) {
-	int count = 0;
-	std::vector<std::shared_ptr<RValue>> param_atoms;
-
-	for (auto& func : _symbolTable._records) {
-		if (func._kind == SymbolTable::TableRecord::RecordKind::func && func._name == function) {
-			stream << '\n' << func._name << ":\n";
+void Translator::generateFunction(std::ostream& stream, Scope scope) {
+	AtomWriter writer(_symbolTable, _stringTable);
+	std::vector<Operand> param_atoms;
 
-			int m = _symbolTable.getM(count);
-			stream << '\t' << "LXI B, 0" << '\n';
-			for (int i = 0; i < m; ++i)
-				stream << '\t' << "PUSH B" << '\n';
-			
-			for (auto& atom : _atoms[count]) {
-				try {
-					atom->generate(stream);
-				}
-				catch (std::exception& e) {
-					std::string err = e.what();
-					if (err == "PARAM") {
+	auto& func = _symbolTable[scope];
+	stream << '\n' << _names[func._name] << ":\n";
 
-						auto p = dynamic_cast<ParamAtom*>(&(*atom));
-						auto p_value = p->_param;
-						param_atoms.push_back(p_value);
+	int m = _symbolTable.getM(scope);
+	stream << '\t' << "LXI B, 0" << '\n';
+	for (int i = 0; i < m; ++i)
+		stream << '\t' << "PUSH B" << '\n';
+	
+	for (auto& atom : _atoms[func._ordinal]) {
+		switch (atom.op) {
+		case AtomOp::param:
+			param_atoms.push_back(atom.result);
+			break;
 
-					}
-					else if (err == "CALL") {
+		case AtomOp::call: {
+			writer.comment(stream, atom);
 
-						stream << "\t\t\t";
-						SetColor(ConsoleColor::Blue, ConsoleColor::White);
-						stream << "; " << atom->toString();
-						SetColor(ConsoleColor::Black, ConsoleColor::White);
-						stream << '\n';
+			auto call_func_name = writer.toString(atom.first);
 
-						auto call_atom = dynamic_cast<CallAtom*>(&(*atom));
-						auto call_func_name = call_atom->_func->toString();
+			this->saveRegs(stream);
 
-						auto ret_oper = call_atom->_ret;
+			stream << '\t' << "LXI B, 0" << '\n';
+			stream << '\t' << "PUSH B" << '\n';
 
+			for (int i = param_atoms.size() - 1; i >= 0; --i) {
+				auto& param_item = param_atoms[i];
 
-						this->saveRegs(stream);
+				stream << '\t' << "LXI B, 0" << '\n';
+				writer.load(stream, param_item, 2 * (4 + (param_atoms.size() - i)));
+				stream << '\t' << "MOV C, A" << '\n';
+				stream << '\t' << "PUSH B" << '\n';
+			}
 
-						stream << '\t' << "LXI B, 0" << '\n';
-						stream << '\t' << "PUSH B" << '\n';
+			stream << '\t' << "CALL " << call_func_name << '\n';
 
-						for (int i = param_atoms.size() - 1; i >= 0; --i) {
-							auto& param_item = param_atoms[i];
+			for (int i = 0; i < param_atoms.size(); ++i) {
+				stream << '\t' << "POP B" << '\n';
+			}
+			stream << '\t' << "POP B" << '\n';
+			stream << '\t' << "MOV A, B" << '\n';
 
-							stream << '\t' << "LXI B, 0" << '\n';
-							param_item->load(stream, 2 * (4 + (param_atoms.size() - i)));
-							stream << '\t' << "MOV C, A" << '\n';
-							stream << '\t' << "PUSH B" << '\n';
-						}
+			writer.save(stream, atom.result, 4 * 2);
 
-						stream << '\t' << "CALL " << call_func_name << '\n';
+			this->loadRegs(stream);
 
-						for (int i = 0; i < param_atoms.size(); ++i) {
-							stream << '\t' << "POP B" << '\n';
-						}
-						stream << '\t' << "POP B" << '\n';
-						stream << '\t' << "MOV A, B" << '\n';
+			param_atoms.clear();
+			break;
+		}
 
-						ret_oper->save(stream, 4 * 2);
+		case AtomOp::ret: {
+			writer.comment(stream, atom);
 
-						this->loadRegs(stream);
+			writer.load(stream, atom.result);
 
+			int n = func._len;
+			int res = 2 * (m + n + 1);
 
+			stream << '\t' << "LXI H, " << res << '\n';
+			stream << '\t' << "DAD sp" << '\n';
+			stream << '\t' << "MOV M, A" << '\n';
 
-						param_atoms.clear();
-					}
-					else if (err == "RET") {
-						stream << "\t\t\t";
-						SetColor(ConsoleColor::Blue, ConsoleColor::White);
-						stream << "; " << atom->toString();
-						SetColor(ConsoleColor::Black, ConsoleColor::White);
-						stream << '\n';
+			for (int i = 0; i < m; ++i) {
+				stream << '\t' << "POP B" << '\n';
+			}
+			stream << '\t' << "RET" << '\n';
+			break;
+		}
 
-						auto ret_atom = dynamic_cast<RetAtom*>(&(*atom));
+		default:
+			writer.generate(stream, atom);
+			break;
+		}
+	}
+}
 
-						ret_atom->_ret->load(stream);
 
-						int n = func._len;
-						int res = 2 * (m + n + 1);
+void Translator::checkMain() {
+	NameId main_name = _names.find("main");
+	for (Scope scope : _symbolTable.functions()) {
+		if (_symbolTable[scope]._name == main_name)
+			return;
+	}
+	syntaxError("Íå íàéäåíî ôóíêöèè main()");
+}
 
-						stream << '\t' << "LXI H, " << res << '\n';
-						stream << '\t' << "DAD sp" << '\n';
-						stream << '\t' << "MOV M, A" << '\n';
 
-						for (int i = 0; i < m; ++i) {
-							stream << '\t' << "POP B" << '\n';
-						}
-						stream << '\t' << "RET" << '\n';
-					}
-					else throw;
-				}
-			}
-		}
-		++count;
-	}
+void Translator::generateData(std::ostream& stream) {
+	stream << '\t' << "ORG 8000H;" << '\n';
+	_symbolTable.generateGlobals(stream);
+	_stringTable.generateStrings(stream);
 }
 
 
 void Translator::generateCode(std::ostream& stream) {
 	_symbolTable.calculateOffset();
+	checkMain();
 
-	bool flag_main = false;
-	for (auto& func_name : _symbolTable.functionNames()) {
-		if (func_name == "main") {
-			flag_main = true;
-			break;
-		}
-	}
+	generateData(stream);
+	generateProlog(stream);
 
-	if (!flag_main) {
-		syntaxError("Íå íàéäåíî ôóíêöèè main()");
-	}
+	for (Scope scope : _symbolTable.functions())
+		generateFunction(stream, scope);
+}
 
-	stream << '\t' << "ORG 8000H;" << '\n';
-	_symbolTable.generateGlobals(stream);
-	_stringTable.generateStrings(stream);
+
+void Translator::endFunction(Scope scope) {
+	auto& atoms = _atoms[_symbolTable[scope]._ordinal];
+	_atomCount += atoms.size();
+	if (_output == nullptr)
+		return;
+
+	// Ïîòîêîâûé ðåæèì: êîä ôóíêöèè ïèøåòñÿ ñðàçó, å¸ àòîìû è ïåðåìåííûå áîëüøå íå íóæíû
+	_symbolTable.calculateOffset(scope);
+	generateFunction(*_output, scope);
+	std::vector<Atom>().swap(atoms);
+	_symbolTable.release(scope);
+}
+
+
+void Translator::compile(std::ostream& stream) {
+	_output = &stream;
 	generateProlog(stream);
 
-	for (auto& func_name : _symbolTable.functionNames()) {
-		generateFunction(stream, func_name);
-	}
+	StmtList(GlobalScope);
+	stopLexer();
+	_output = nullptr;
+
+	checkMain();
+	generateData(stream);
 }
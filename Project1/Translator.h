@@ -1,49 +1,116 @@
 #pragma once
-#include <map>
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "Atoms.h"
+#include "ConcurrentInterner.h"
+#include "ExpressionTables.h"
+#include "Interner.h"
+#include "ParallelLexer.h"
 #include "StringTable.h"
 #include "SymbolTable.h"
 #include "Scanner.h"
 #include "Token.h"
-
+#include "TokenBuffer.h"
+#include "TokenPipe.h"
+
+// Îòêóäà ïàðñåð áåð¸ò ëåêñåìû
+enum class LexMode {
+	// Ïî îäíîé ó ñêàíåðà ïî ìåðå ðàçáîðà
+	onDemand,
+	// Âåñü âõîä ðàçáèðàåòñÿ íà ëåêñåìû çàðàíåå, â TokenBuffer
+	batch,
+	// Ñêàíåð ðàáîòàåò â îòäåëüíîì ïîòîêå è ïåðåäà¸ò ëåêñåìû ÷åðåç TokenPipe
+	pipelined,
+	// Êàê batch, íî êóñêè òåêñòà ìåæäó ôóíêöèÿìè ðàçáèðàþòñÿ íà íåñêîëüêèõ ïîòîêàõ.
+	// Ïîòîê íåëüçÿ ïîäåëèòü, íå ïðî÷èòàâ öåëèêîì, ïîýòîìó äëÿ íåãî ýòî òî æå, ÷òî batch
+	parallel
+};
 
 class Translator {
 private:
-	std::map<Scope, std::vector<std::unique_ptr<Atom>>> _atoms;
+	// Òàáëèöà èì¸í êîìïèëÿöèè: å¸ çàïîëíÿåò ñêàíåð, ïî íîìåðàì èì¸í ðàáîòàåò òàáëèöà ñèìâîëîâ.
+	// Ðàáî÷èé ïàðàëëåëüíîãî ðàçáîðà ÷èòàåò òàáëèöó ãëàâíîãî òðàíñëÿòîðà, _ownNames ó íåãî ïóñòà
+	Interner _ownNames;
+	Interner& _names;
+
+	// Àòîìû ôóíêöèé ïî èõ ïîðÿäêîâûì íîìåðàì (TableRecord::_ordinal)
+	std::vector<std::vector<Atom>> _atoms;
+	// Àòîìîâ âî âñåõ ôóíêöèÿõ, êðîìå ïîñëåäíåé
+	size_t _atomCount = 0;
+	// Ðàçìåð èñõîäíîãî òåêñòà â áàéòàõ, 0 - íåèçâåñòåí (ïîòîê)
+	size_t _sourceSize = 0;
+	// Áàéò òåêñòà íà àòîì (íà ïðèìåðàõ 3.5..6) è ïðåäåë çàïàñà ïîä ïåðâóþ ôóíêöèþ
+	static constexpr size_t SourceBytesPerAtom = 4;
+	static constexpr size_t MaxFirstReserve = 4096;
+	size_t expectedAtoms() const;
 
 	StringTable _stringTable;
 	SymbolTable _symbolTable;
 	Scanner _scanner;
+	LexMode _lexMode;
+	TokenBuffer _tokens;
+	// Ëåêñåìû, ïî êîòîðûì èä¸ò ðàçáîð â ðåæèìàõ batch è parallel: ñâîè _tokens,
+	// ó ðàáî÷åãî ïàðàëëåëüíîãî ðàçáîðà - ëåêñåìû ãëàâíîãî òðàíñëÿòîðà
+	const TokenBuffer* _tokenSource;
+	// Èíäåêñ ñëåäóþùåé ëåêñåìû â *_tokenSource è êîíåö ðàçáèðàåìîãî ó÷àñòêà, çà íèì - eof
+	size_t _tokenIndex = 0;
+	size_t _tokenEnd = SIZE_MAX;
+	TokenPipe _pipe;
+	std::thread _lexerThread;
 	Token _currentToken;
 	int _currentLabel;
 	void lexCheck();
+	// Ïåðåéòè ê ñëåäóþùåé ëåêñåìå
+	void nextToken() {
+		if (_lexMode == LexMode::batch or _lexMode == LexMode::parallel)
+			_currentToken = _tokenIndex < _tokenEnd ? (*_tokenSource)[_tokenIndex++] : Token(LexemType::eof);
+		else if (_lexMode == LexMode::pipelined)
+			_currentToken = _pipe.pop();
+		else
+			_currentToken = _scanner.getNextToken();
+	};
+	// Äîæäàòüñÿ çàâåðøåíèÿ ïîòîêà ñêàíåðà (ðåæèì pipelined)
+	void stopLexer() {
+		if (_lexerThread.joinable()) {
+			_pipe.cancel();
+			_lexerThread.join();
+		}
+	};
+	// Òåêñò èìåíè. Â ðåæèìå pipelined òàáëèöó èì¸í ïîïîëíÿåò ïîòîê ñêàíåðà,
+	// ïîýòîìó ïåðåä ÷òåíèåì òàáëèöû îí îñòàíàâëèâàåòñÿ
+	std::string_view nameText(NameId name) {
+		stopLexer();
+		return _names[name];
+	};
+	// Òèï ëåêñåìû íà k ïîçèöèé ïîñëå òåêóùåé (peek(0) - ñàìà òåêóùàÿ).
+	// Çàãëÿäûâàòü âïåð¸ä ìîæíî òîëüêî â ðåæèìàõ batch è parallel
+	LexemType peek(size_t k) const {
+		if (k == 0)
+			return _currentToken.type();
+		size_t index = _tokenIndex + k - 1;
+		return index < std::min(_tokenEnd, _tokenSource->size()) ? _tokenSource->type(index) : LexemType::eof;
+	};
 
-	std::shared_ptr<NumberOperand> one, zero;
-	std::map<LexemType, std::string> simple_jumps;
+	static constexpr Operand one = Operand::number(1), zero = Operand::number(0);
 
 	
 
 
-	std::shared_ptr<RValue> E(Scope);
+	Operand E(Scope);
 
-	std::shared_ptr<RValue> E1(Scope);
-	std::shared_ptr<RValue> E1_(std::string, Scope);
-	std::shared_ptr<RValue> E2(Scope);
-	std::shared_ptr<RValue> E3(Scope);
-	std::shared_ptr<RValue> E3_(std::shared_ptr<RValue>, Scope);
-	std::shared_ptr<RValue> E4(Scope);
-	std::shared_ptr<RValue> E4_(std::shared_ptr<RValue>, Scope);
-	std::shared_ptr<RValue> E5(Scope);
-	std::shared_ptr<RValue> E5_(std::shared_ptr<RValue>, Scope);
-	std::shared_ptr<RValue> E6(Scope);
-	std::shared_ptr<RValue> E6_(std::shared_ptr<RValue>, Scope);
-	std::shared_ptr<RValue> E7(Scope);
-	std::shared_ptr<RValue> E7_(std::shared_ptr<RValue>, Scope);
+	Operand E1(Scope);
+	Operand E1_(NameId, Scope);
+	Operand E2(Scope);
+	// Áèíàðíûå îïåðàòîðû ñ ñèëîé ñâÿçûâàíèÿ íå ìåíüøå minPower (òàáëèöà binaryOperators)
+	Operand BinaryExpr(Scope, int minPower);
 
 	void DeclareStmt(Scope);
-	void DeclareStmt_(SymbolTable::TableRecord::RecordType, std::string, Scope);
+	void DeclareStmt_(SymbolTable::TableRecord::RecordType, NameId, Scope);
 	SymbolTable::TableRecord::RecordType Type(Scope);
 
 	int ParamList(Scope);
@@ -55,7 +122,7 @@ private:
 	void Stmt(Scope);
 	void AssignOrCallOp(Scope);
 	void AssignOrCall(Scope);
-	void AssignOrCall_(Scope, std::string);
+	void AssignOrCall_(Scope, NameId);
 	void IfOp(Scope);
 	void ElsePart(Scope);
 	void IOp(Scope);
@@ -64,53 +131,102 @@ private:
 	void WhileOp(Scope);
 	void ForOp(Scope);
 	void SwitchOp(Scope);
-	void Cases(Scope, std::shared_ptr<RValue>, std::shared_ptr<LabelOperand>);
-	void Cases_(Scope, std::shared_ptr<RValue>, std::shared_ptr<LabelOperand>, std::shared_ptr<LabelOperand>);
-	std::shared_ptr<LabelOperand> ACase(Scope, std::shared_ptr<RValue>, std::shared_ptr<LabelOperand>);
+	void Cases(Scope, Operand, Operand);
+	void Cases_(Scope, Operand, Operand, Operand);
+	Operand ACase(Scope, Operand, Operand);
 	
 	void ForInit(Scope);
-	std::shared_ptr<RValue> ForExpr(Scope);
+	Operand ForExpr(Scope);
 	void ForLoop(Scope);
 
 	int ArgList(Scope);
-	int ArgList_(Scope);
+	void ArgList_(Scope, std::vector<Operand>&);
 
 	void DeclVarList_(SymbolTable::TableRecord::RecordType, Scope);
 
-	void InitVar(SymbolTable::TableRecord::RecordType, std::string, Scope);
+	void InitVar(SymbolTable::TableRecord::RecordType, NameId, Scope);
 
 
 	void saveRegs(std::ostream&);
 	void loadRegs(std::ostream&);
 	void generateProlog(std::ostream&);
-	void generateFunction(std::ostream&, std::string);
+	// Ãëîáàëüíûå ïåðåìåííûå è ñòðîêè
+	void generateData(std::ostream&);
+	void generateFunction(std::ostream&, Scope);
+	void checkMain();
+	// Êîíåö ðàçáîðà ôóíêöèè; â ïîòîêîâîì ðåæèìå - ïîðîæäåíèå å¸ êîäà è îñâîáîæäåíèå àòîìîâ
+	void endFunction(Scope);
+	// Êóäà ïèñàòü êîä â ïîòîêîâîì ðåæèìå (compile), èíà÷å nullptr
+	std::ostream* _output = nullptr;
+
+	// Ïàðàëëåëüíûé ðàçáîð ïî ôóíêöèÿì (ParallelTranslator.cpp)
+	// Ðàáî÷èé, ðàçáèðàþùèé ëåêñåìû parent ñ first ïî last (íå âêëþ÷àÿ) ñ òàáëèöåé èì¸í parent
+	Translator(const Translator& parent, size_t first, size_t last);
+	struct TopLevelItem;
+	struct FunctionUnit;
+	bool splitTopLevel(std::vector<TopLevelItem>& items, std::unordered_map<NameId, size_t>& declared) const;
+	void parseFunction(FunctionUnit& unit, const std::vector<TopLevelItem>& items,
+					   const std::unordered_map<NameId, size_t>& declared, size_t index, ConcurrentInterner& strings) const;
+	bool canMerge(const std::vector<TopLevelItem>& items, const std::vector<FunctionUnit>& units) const;
+	void mergeFunctions(const std::vector<TopLevelItem>& items, std::vector<FunctionUnit>& units, const ConcurrentInterner& strings);
+	// Ðàáî÷èé ïàðàëëåëüíîãî ðàçáîðà êëàä¸ò ñòðîêè â îáùóþ òàáëèöó; _stringOrder - êëþ÷ ïîðÿäêà ñëåäóþùåé
+	ConcurrentInterner* _sharedStrings = nullptr;
+	uint64_t _stringOrder = 0;
+
+	void init() {
+		if (_lexMode == LexMode::batch)
+			_tokens.fill(_scanner);
+		if (_lexMode == LexMode::pipelined)
+			_lexerThread = std::thread([this]() { _pipe.run(_scanner); });
+		nextToken();
+	};
 
 
 public:
-	Translator(std::istream& stream) : _scanner{ stream }, _currentLabel{ 1 } { 
-		_currentToken = _scanner.getNextToken();
-		one = std::make_shared<NumberOperand>(1);
-		zero = std::make_shared<NumberOperand>(0);
-		simple_jumps = {
-			{LexemType::opeq, "EQ"},
-			{LexemType::opne, "NE"},
-			{LexemType::opgt, "GT"},
-			{LexemType::oplt, "LT"}
-		};
+	Translator(std::istream& stream, LexMode lexMode = LexMode::onDemand)
+		: _names{ _ownNames }, _symbolTable{ _names }, _scanner{ stream, &_names }, _lexMode{ lexMode }, _tokens{ _names }, _tokenSource{ &_tokens }, _currentLabel{ 1 } {
+		if (_lexMode == LexMode::parallel)
+			_lexMode = LexMode::batch;
+		init();
+	};
+	Translator(const char* begin, const char* end, LexMode lexMode = LexMode::onDemand)
+		: _names{ _ownNames }, _sourceSize{ static_cast<size_t>(end - begin) }, _symbolTable{ _names }, _scanner{ begin, end, &_names }, _lexMode{ lexMode }, _tokens{ _names }, _tokenSource{ &_tokens }, _currentLabel{ 1 } {
+		if (_lexMode == LexMode::parallel)
+			lexParallel(begin, end, _names, _tokens);
+		init();
+	};
+
+	~Translator() {
+		stopLexer();
 	};
 
 	void printAtoms(std::ostream&);
-	void generateAtom(std::unique_ptr<Atom> atom, Scope);
-	std::shared_ptr<LabelOperand> newLabel();
+	void generateAtom(const Atom& atom, Scope);
+	Operand newLabel();
+	Operand number(int value);
 	void syntaxError(const std::string& message);
 	void lexicalError(const std::string& message);
 
 	bool translate() {
 		StmtList(GlobalScope);
+		stopLexer();
 		_symbolTable.calculateOffset();
 		return true;
 	};
 
+	// Òî æå, ÷òî translate(), íî òåëà ôóíêöèé ðàçáèðàþòñÿ ïàðàëëåëüíî íà threads ïîòîêàõ (0 - ïî ÷èñëó ÿäåð).
+	// Íóæåí òåêñò â áóôåðå è ðåæèì batch èëè parallel, èíà÷å ðàçáîð ïîñëåäîâàòåëüíûé. Ðåçóëüòàò ñîâïàäàåò
+	// ñ translate(); ïðîãðàììó ñ îøèáêîé èëè íåîáû÷íîãî âèäà ðàçáèðàåò translate()
+	bool translateParallel(unsigned threads = 0);
+
 	void generateCode(std::ostream&);
 
+	// Ïîòîêîâàÿ êîìïèëÿöèÿ: êîä êàæäîé ôóíêöèè ïèøåòñÿ, êàê òîëüêî ðàçîáðàíà å¸ çàêðûâàþùàÿ ñêîáêà,
+	// ïîñëå ÷åãî å¸ àòîìû è çàïèñè òàáëèöû ñèìâîëîâ îñâîáîæäàþòñÿ. Ïàìÿòü îãðàíè÷åíà ñàìîé áîëüøîé
+	// ôóíêöèåé, à íå âñåé ïðîãðàììîé, òîëüêî â ðåæèìàõ onDemand è pipelined: â batch è parallel âñå
+	// ëåêñåìû ïðîãðàììû óæå ëåæàò â _tokens, è îãðàíè÷åíû ëèøü àòîìû è òàáëèöà ñèìâîëîâ.
+	// Ïðîëîã èä¸ò â íà÷àëå, ãëîáàëüíûå ïåðåìåííûå è ñòðîêè - â êîíöå.
+	// printAtoms ïîñëå ýòîãî íå ïîêàçûâàåò óæå ïîðîæä¸ííûå ôóíêöèè
+	void compile(std::ostream&);
+
 };
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "MappedFile.h"
 #include "Scanner.h"
 #include "Translator.h"
 
@@ -32,9 +33,9 @@ int main() {
 
 	std::cout << "\n\n\n";
 
-	ifs.open(file_name);
-	Translator myTranslator(ifs);
 	try {
+		MappedFile source(file_name);
+		Translator myTranslator(source.begin(), source.end(), LexMode::batch);
 		if (myTranslator.translate())
 			std::cout << "Syntax OK";
 		else
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ConcurrentInterner.h"
+#include "Tools.h"
+
+
+// Íàãðóçêà, ïîõîæàÿ íà ñòðîêè ïàðàëëåëüíîãî ðàçáîðà: êàæäûé ïîòîê çàíîñèò îêíî èç Vocabulary / 2 èì¸í,
+// îêíà ñîñåäíèõ ïîòîêîâ ïåðåñåêàþòñÿ, òàê ÷òî áîëüøàÿ ÷àñòü âñòàâîê - óæå èçâåñòíûå òåêñòû.
+// Äëÿ ñðàâíåíèÿ òî æå ñàìîå äåëàåòñÿ ñ std::unordered_map ïîä îäíèì mutex
+namespace {
+
+const int Vocabulary = 60000;
+
+// Íîìåð ñëîâà, êîòîðîå ïîòîê thread çàíîñèò i-ì
+int wordOf(int thread, int i) {
+	return (thread * Vocabulary / 8 + i % (Vocabulary / 2)) % Vocabulary;
+}
+
+template <typename Work>
+double timeThreads(int threads, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (int t = 0; t < threads; ++t)
+		pool.emplace_back(work, t);
+	for (auto& thread : pool)
+		thread.join();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+// renumber() äîëæåí âûäàòü íîìåðà ïî âîçðàñòàíèþ êëþ÷à ïîðÿäêà - çäåñü ýòî íîìåð ñëîâà,
+// íåçàâèñèìî îò òîãî, â êàêîì ïîðÿäêå ïðèøëè ïîòîêè
+bool deterministic(const ConcurrentInterner& interner, const std::vector<std::string>& words, int threads, int operations) {
+	std::vector<uint32_t> renumbered = interner.renumber();
+	std::vector<bool> inserted(Vocabulary, false);
+	for (int t = 0; t < threads; ++t) {
+		for (int i = 0; i < Vocabulary / 2 and i < operations; ++i)
+			inserted[wordOf(t, i)] = true;
+	}
+
+	uint32_t rank = 0;
+	for (int w = 0; w < Vocabulary; ++w) {
+		if (!inserted[w])
+			continue;
+		uint32_t id = interner.find(words[w]);
+		if (id == ConcurrentInterner::NotFound or renumbered[id] != rank)
+			return false;
+		++rank;
+	}
+	return rank == interner.size();
+}
+
+}
+
+
+int runInternerBench(int operations) {
+	std::vector<std::string> words(Vocabulary);
+	for (int i = 0; i < Vocabulary; ++i)
+		words[i] = "ident_" + std::to_string(i * 7919 % 100003);
+
+	std::cout << "Âñòàâîê íà ïîòîê: " << operations << ", ìëí îïåðàöèé â ñåêóíäó\n";
+	bool ok = true;
+	for (int threads = 1; threads <= 64; threads *= 2) {
+		ConcurrentInterner interner;
+		double internerTime = timeThreads(threads, [&](int thread) {
+			for (int i = 0; i < operations; ++i) {
+				int w = wordOf(thread, i);
+				interner.intern(words[w], static_cast<uint64_t>(w));
+			}
+		});
+
+		std::mutex mutex;
+		std::unordered_map<std::string_view, uint32_t> map;
+		double mapTime = timeThreads(threads, [&](int thread) {
+			for (int i = 0; i < operations; ++i) {
+				int w = wordOf(thread, i);
+				std::lock_guard<std::mutex> lock(mutex);
+				map.emplace(words[w], static_cast<uint32_t>(map.size()));
+			}
+		});
+
+		bool same = deterministic(interner, words, threads, operations);
+		ok = ok and same;
+		double total = static_cast<double>(threads) * operations / 1e6;
+		std::cout << "  ïîòîêîâ " << threads << ": ConcurrentInterner " << total / internerTime
+			<< ", mutex + unordered_map " << total / mapTime
+			<< ", òåêñòîâ " << interner.size() << (same ? "" : ", íîìåðà çàâèñÿò îò ðàñïèñàíèÿ!") << "\n";
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ScanKernels.h"
+#include "Scanner.h"
+#include "SwitchScanner.h"
+#include "Tools.h"
+
+
+namespace {
+
+// Ñêàíåð, ðàçáèðàþùèé source ñ íà÷àëà: ïðåæíèé íà switch èëè òàáëè÷íûé
+struct Variant {
+	const char* name;
+	// ×èòàåò ïîòîê, à íå áóôåð
+	bool stream;
+	// ßäðà òàáëè÷íîãî ñêàíåðà áóôåðà
+	const ScanKernels* kernels;
+};
+
+// Îäíà è òà æå ëåêñåìà: òèï, çíà÷åíèå ó num è chr, òåêñò ó id, str è error
+bool sameToken(const Token& a, const Token& b) {
+	if (a.type() != b.type())
+		return false;
+	switch (a.type()) {
+		case LexemType::num:
+		case LexemType::chr:
+			return a.value() == b.value();
+		case LexemType::id:
+		case LexemType::str:
+		case LexemType::error:
+			return a.str() == b.str();
+		default:
+			return true;
+	}
+}
+
+// Ïðîõîä ñêàíåðà variant ïî source; äëÿ êàæäîé ëåêñåìû âûçûâàåòñÿ visit, false - îñòàíîâèòüñÿ
+void scan(const Variant& variant, const std::string& source, const std::function<bool(Token&)>& visit) {
+	std::istringstream stream(source);
+	if (variant.kernels == nullptr) {
+		SwitchScanner scanner(stream);
+		for (Token token = scanner.getNextToken(); visit(token) and token.type() != LexemType::eof; token = scanner.getNextToken())
+			;
+		return;
+	}
+
+	const char* begin = source.data();
+	Scanner scanner = variant.stream ? Scanner(stream) : Scanner(begin, begin + source.size(), nullptr, *variant.kernels);
+	for (Token token = scanner.getNextToken(); visit(token) and token.type() != LexemType::eof; token = scanner.getNextToken())
+		;
+}
+
+// Ëó÷øåå âðåìÿ ïðîõîäà èç repeats
+double measure(const Variant& variant, const std::string& source, int repeats) {
+	double best = 0;
+	for (int r = 0; r < repeats; ++r) {
+		auto start = std::chrono::steady_clock::now();
+		scan(variant, source, [](Token&) { return true; });
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		if (r == 0 or elapsed.count() < best)
+			best = elapsed.count();
+	}
+	return best;
+}
+
+// Ëåêñåìû variant ñîâïàäàþò ñ ëåêñåìàìè ïðåæíåãî ñêàíåðà; count - èõ ÷èñëî
+bool sameTokens(const Variant& variant, const std::string& source, size_t& count) {
+	std::vector<Token> expected;
+	std::vector<std::string> texts;
+	scan(Variant{ "switch", true, nullptr }, source, [&](Token& token) {
+		// Òåêñò ïðåæíåãî ñêàíåðà æèâ¸ò äî ñëåäóþùåé ëåêñåìû
+		texts.emplace_back(token.str());
+		expected.push_back(token);
+		return true;
+	});
+	for (size_t i = 0; i < expected.size(); ++i) {
+		if (!expected[i].str().empty())
+			expected[i] = Token(expected[i].type(), texts[i], expected[i].value());
+	}
+
+	size_t index = 0;
+	bool same = true;
+	scan(variant, source, [&](Token& token) {
+		same = index < expected.size() and sameToken(expected[index], token);
+		if (!same)
+			std::cout << "  " << variant.name << ": ëåêñåìà " << index << " îòëè÷àåòñÿ îò ïðåæíåãî ñêàíåðà\n";
+		++index;
+		return same;
+	});
+	count = expected.size();
+	return same and index == expected.size();
+}
+
+}
+
+
+int runLexerBench(const std::string& fileName, int repeats) {
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file) {
+		std::cout << "Íå óäàëîñü îòêðûòü " << fileName << "\n";
+		return 2;
+	}
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	const std::string source = buffer.str();
+
+	// Ïðåæíèé ñêàíåð ÷èòàë ïîòîê ïî ñèìâîëó; òàáëè÷íûé - òîò æå ïîòîê áëîêàìè èëè áóôåð,
+	// áåç âåêòîðíûõ ÿäåð (ñðàâíåíèå ñàìèõ àâòîìàòîâ) è ñ ëó÷øèìè
+	const Variant variants[] = {
+		{ "switch, istream::get()", true, nullptr },
+		{ "DFA, istream áëîêàìè", true, &scanKernels() },
+		{ "DFA, áóôåð, scalar", false, &scalarScanKernels() },
+		{ "DFA, áóôåð, ëó÷øèå ÿäðà", false, &scanKernels() },
+	};
+
+	bool same = true;
+	size_t tokens = 0;
+	for (size_t v = 1; v < std::size(variants); ++v)
+		same = sameTokens(variants[v], source, tokens) and same;
+
+	std::cout << source.size() / 1024 << " ÊÁ, " << tokens << " ëåêñåì, ëó÷øèé èç " << repeats << " ïðîõîäîâ\n";
+	double baseline = 0;
+	for (auto& variant : variants) {
+		double time = measure(variant, source, repeats);
+		if (variant.kernels == nullptr)
+			baseline = time;
+		std::cout << "  " << variant.name << ": " << time * 1000 << " ìñ, "
+			<< source.size() / time / (1024 * 1024) << " ÌÁ/ñ, x" << baseline / time << "\n";
+	}
+	if (!same)
+		std::cout << "Ëåêñåìû òàáëè÷íîãî ñêàíåðà îòëè÷àþòñÿ îò ïðåæíåãî\n";
+	return same ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Translator.h"
+#include "Tools.h"
+
+
+// Íàãðóçî÷íàÿ ïðîâåðêà èòåðàòèâíîãî ðàçáîðà: ñïèñêè îïåðàòîðîâ, case, îáúÿâëåíèé, ïàðàìåòðîâ,
+// àðãóìåíòîâ è öåïî÷êè îïåðàòîðîâ â îäíîé ôóíêöèè. Ðåêóðñèâíîìó ðàçáîðó íà òàêèõ ïðîãðàììàõ
+// íå õâàòèëî áû ñòåêà. Äëèíû ñïèñêîâ, ïîðîæäàþùèõ ïåðåìåííûå, îãðàíè÷åíû êàäðîì ôóíêöèè â 64 ÊÁ
+namespace {
+
+// Îïåðàòîð íà ñòðîêó: a = i; b = a;
+std::string statements(size_t count) {
+	std::string text = "int main() {\n\tint a, b;\n";
+	for (size_t i = 0; i < count; ++i)
+		text += i % 2 ? "\tb = a;\n" : "\ta = " + std::to_string(i % 1000) + ";\n";
+	return text + "}\n";
+}
+
+std::string cases(size_t count) {
+	std::string text = "int main() {\n\tint a;\n\tswitch (a) {\n";
+	for (size_t i = 0; i < count; ++i)
+		text += "\tcase " + std::to_string(i) + ": a = 1;\n";
+	return text + "\tdefault: a = 0;\n\t}\n}\n";
+}
+
+std::string declarators(size_t count) {
+	std::string text = "int main() {\n\tint v0";
+	for (size_t i = 1; i < count; ++i)
+		text += ", v" + std::to_string(i);
+	return text + ";\n}\n";
+}
+
+// Ôóíêöèÿ ñ count ïàðàìåòðàìè è å¸ âûçîâ ñ count àðãóìåíòàìè
+std::string arguments(size_t count) {
+	std::string text = "int f(int p0";
+	for (size_t i = 1; i < count; ++i)
+		text += ", int p" + std::to_string(i);
+	text += ") {\n\treturn p0;\n}\nint main() {\n\tint a;\n\ta = f(1";
+	for (size_t i = 1; i < count; ++i)
+		text += ", 1";
+	return text + ");\n}\n";
+}
+
+// a = 1 + 2 * 1 - 1 ...: êàæäàÿ îïåðàöèÿ - âðåìåííàÿ ïåðåìåííàÿ
+std::string chain(size_t count) {
+	static const char* const operators[] = { " + ", " * ", " - " };
+	std::string text = "int main() {\n\tint a;\n\ta = 1";
+	for (size_t i = 0; i < count; ++i)
+		text += operators[i % 3] + std::to_string(i % 10 + 1);
+	return text + ";\n}\n";
+}
+
+struct StressCase {
+	const char* name;
+	std::string (*generate)(size_t);
+	size_t count;
+};
+
+const size_t DefaultStatements = 2000000;
+
+StressCase stressCases[] = {
+	{ "statements", statements, DefaultStatements },
+	{ "cases", cases, 200000 },
+	{ "declarators", declarators, 30000 },
+	{ "arguments", arguments, 30000 },
+	{ "chain", chain, 30000 },
+};
+
+StressCase* findCase(const std::string& name) {
+	for (auto& test : stressCases) {
+		if (name == test.name)
+			return &test;
+	}
+	return nullptr;
+}
+
+}
+
+
+int runStress(size_t statementCount) {
+	int failed = 0;
+	for (auto& test : stressCases) {
+		size_t count = test.generate == statements and statementCount != 0 ? statementCount : test.count;
+		std::string source = test.generate(count);
+		std::cout << test.name << " (" << count << ", " << source.size() / 1024 << " ÊÁ): " << std::flush;
+
+		auto start = std::chrono::steady_clock::now();
+		try {
+			Translator translator(source.data(), source.data() + source.size(), LexMode::batch);
+			if (!translator.translate())
+				throw std::exception("SyntaxError");
+			// Êîä íèêóäà íå âûâîäèòñÿ: ïðîâåðÿåòñÿ òîëüêî, ÷òî îí ïîðîæäàåòñÿ
+			std::ostream sink(nullptr);
+			translator.generateCode(sink);
+
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			std::cout << "OK, " << elapsed.count() << " ñ\n";
+		}
+		catch (std::exception& e) {
+			++failed;
+			std::cout << "FAIL " << e.what() << "\n";
+		}
+	}
+	return failed;
+}
+
+
+int generateStress(const std::string& name, size_t count, const std::string& fileName) {
+	StressCase* test = findCase(name);
+	if (test == nullptr) {
+		std::cout << "Íåò òàêîé ïðîãðàììû: " << name << "\n";
+		return 2;
+	}
+
+	std::ofstream file(fileName, std::ios::binary);
+	file << test->generate(count != 0 ? count : test->count);
+	return file ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <istream>
+#include <string>
+
+#include "Token.h"
+
+// Ïðåæíèé ñêàíåð íà switch ïî ñîñòîÿíèÿì, äëÿ ñðàâíåíèÿ ñ òàáëè÷íûì àâòîìàòîì (Tools lexbench).
+// Àâòîìàò è ÷òåíèå òå æå, ÷òî äî ïåðåõîäà íà LexerTables: ïî ñèìâîëó ÷åðåç std::istream::get().
+// Îòëè÷èå îäíî: Token òåïåðü íå âëàäååò òåêñòîì, ïîýòîìó òåêñò ëåêñåìû - ÷ëåí ñêàíåðà, à íå ëîêàëüíàÿ ñòðîêà
+class SwitchScanner {
+public:
+	SwitchScanner(std::istream& stream) : input_stream(stream) {};
+
+	// Òåêñò id è str äåéñòâèòåëåí äî ñëåäóþùåãî âûçîâà
+	Token getNextToken();
+
+private:
+	// Âõîäíîé ïîòîê, îòêóäà áóäåì áðàòü ñèìâîëû
+	std::istream& input_stream;
+	// Åñëè ìû óæå çàêîí÷èëè
+	bool is_stopped = false;
+	// Ñîñòîÿíèå
+	int State = 0;
+	// Íàêîïëåííûé òåêñò ëåêñåìû
+	std::string value;
+
+	// Âîçâðàù¸ííûé â ïîòîê ñèìâîë
+	char returnedChar = 0;
+	// Ôëàã, åñëè åñòü âîçâðàù¸ííûé ñèìâîë
+	bool is_returned = false;
+};
@@ -0,0 +1,138 @@
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "Scanner.h"
+#include "Translator.h"
+#include "Tools.h"
+
+
+namespace {
+
+struct TestCase {
+	const char* name;
+	// Èñõîäíûé òåêñò. Ñèìâîë @ çàìåíÿåòñÿ ïðîáåëàìè òàê, ÷òîáû ñëåäóþùèé çà íèì ñèìâîë
+	// îêàçàëñÿ çà 4 áàéòà äî êîíöà ïåðâîãî áëîêà ÷òåíèÿ ïîòîêà: ëåêñåìà ïåðåñå÷¸ò ãðàíèöó áëîêîâ
+	const char* source;
+	// Ïîäñòðîêà ñîîáùåíèÿ îá îøèáêå; nullptr - ïðîãðàììà äîëæíà òðàíñëèðîâàòüñÿ
+	const char* error;
+	// Ïîäñòðîêà ïîðîæä¸ííîãî êîäà; nullptr - êîä íå ïðîâåðÿåòñÿ
+	const char* code = nullptr;
+};
+
+const TestCase testCases[] = {
+	{ "íàèáîëüøèé îïåðàíä", "int main() { int a; a = 268435455; }", nullptr },
+	{ "÷èñëî âíå äèàïàçîíà îïåðàíäà", "int main() { int a; a = 268435456; }", "âíå äèàïàçîíà" },
+	{ "íàèáîëüøåå int", "int main() { int a; a = 2147483647; }", "âíå äèàïàçîíà" },
+	{ "int + 1", "int main() { int a; a = 2147483648; }", "íå ïîìåùàåòñÿ â int" },
+	{ "2^32 + 1 íå ñâîðà÷èâàåòñÿ â 1", "int main() { int a; a = 4294967297; }", "íå ïîìåùàåòñÿ â int" },
+	{ "äëèííîå ÷èñëî", "int main() { int a; a = 99999999999999999999999999; }", "íå ïîìåùàåòñÿ â int" },
+	{ "÷èñëî íà ãðàíèöå áëîêîâ", "int main() { int a; a = @4294967297; }", "íå ïîìåùàåòñÿ â int" },
+	{ "ïðèñâàèâàíèå êîíñòàíòíîìó ïàðàìåòðó", "int f(const int a) { a = 2; } int main() { f(1); }", "êîíñòàíòíóþ" },
+	{ "ïóñòàÿ ñòðîêà", "int main() { out \"\"; out \"a\"; out \"\"; }", nullptr },
+	{ "íåñêîëüêî ôóíêöèé", "int f(int a) { int b; b = a + 1; return b; } int g() { int b; b = f(2); return b; } int main() { out g(); }", nullptr },
+	// compile() ê ýòîìó âðåìåíè óæå îñâîáîäèë ïåðåìåííûå f, íî èìÿ x îñòà¸òñÿ çàíÿòûì
+	{ "ôóíêöèÿ ñ èìåíåì ïåðåìåííîé ôóíêöèè âûøå", "int f() { int x; x = 1; return x; } int x() { return 2; } int main() { f(); }", "Èìÿ ôóíêöèè <x> óæå îáúÿâëåíî" },
+	{ "ôóíêöèÿ ñ èìåíåì ïàðàìåòðà ôóíêöèè âûøå", "int f(int y) { return y; } int y() { return 2; } int main() { f(1); }", "Èìÿ ôóíêöèè <y> óæå îáúÿâëåíî" },
+	// \n - îäèí áàéò: îáùèé õâîñò "roots\n" ýêîíîìèò 7 áàéò, à íå 8 ñèìâîëîâ
+	{ "îáùèé õâîñò ñ escape", "int main() { out \"Two roots\\n\"; out \"roots\\n\"; }", nullptr, "str1 EQU str0+4\n; 7 bytes saved" },
+	// Ïåðåä õâîñòîì escape-ïîñëåäîâàòåëüíîñòü: ñäâèã â áàéòàõ íåèçâåñòåí, ñòðîêà ðàçìåùàåòñÿ îòäåëüíî
+	{ "õâîñò ïîñëå escape", "int main() { out \"a\\nroots\"; out \"roots\"; }", nullptr, "str1: DB 'roots', 0" },
+};
+
+// ×åì òðàíñëèðóåòñÿ ïðîãðàììà
+enum class Run {
+	translate,
+	parallel,
+	// Ïîòîêîâàÿ êîìïèëÿöèÿ: êîä ôóíêöèé ïîðîæäàåòñÿ ïî õîäó ðàçáîðà
+	compile
+};
+
+struct ModeCase {
+	const char* name;
+	LexMode mode;
+	// ×èòàòü èç ïîòîêà, à íå èç áóôåðà
+	bool stream;
+	Run run;
+};
+
+const ModeCase modes[] = {
+	{ "ïîòîê", LexMode::onDemand, true, Run::translate },
+	{ "áóôåð", LexMode::onDemand, false, Run::translate },
+	{ "batch", LexMode::batch, false, Run::translate },
+	{ "pipelined", LexMode::pipelined, false, Run::translate },
+	{ "pipelined, ïîòîê", LexMode::pipelined, true, Run::translate },
+	{ "parallel", LexMode::parallel, false, Run::parallel },
+	{ "compile, ïîòîê", LexMode::onDemand, true, Run::compile },
+	{ "compile, áóôåð", LexMode::onDemand, false, Run::compile },
+	{ "compile, pipelined", LexMode::pipelined, false, Run::compile },
+	{ "compile, pipelined, ïîòîê", LexMode::pipelined, true, Run::compile },
+};
+
+
+std::string expand(const char* source) {
+	std::string text = source;
+	size_t at = text.find('@');
+	if (at != std::string::npos)
+		text.replace(at, 1, Scanner::DefaultChunkSize - 4 - at, ' ');
+	return text;
+}
+
+
+// Ñîîáùåíèå îá îøèáêå òðàíñëÿöèè èëè ïóñòàÿ ñòðîêà; ïîðîæä¸ííûé êîä - â output
+std::string translate(const std::string& source, const ModeCase& mode, std::string& output) {
+	try {
+		std::istringstream stream(source);
+		std::unique_ptr<Translator> translator(mode.stream
+			? new Translator(stream, mode.mode)
+			: new Translator(source.data(), source.data() + source.size(), mode.mode));
+		std::ostringstream code;
+		if (mode.run == Run::compile) {
+			translator->compile(code);
+			output = code.str();
+			return std::string();
+		}
+
+		bool ok = mode.run == Run::parallel ? translator->translateParallel(2) : translator->translate();
+		if (!ok)
+			return "SyntaxError";
+		translator->generateCode(code);
+		output = code.str();
+		return std::string();
+	}
+	catch (std::exception& e) {
+		return e.what();
+	}
+}
+
+}
+
+
+int runTests() {
+	int failed = 0;
+	int total = 0;
+
+	for (auto& test : testCases) {
+		std::string source = expand(test.source);
+		for (auto& mode : modes) {
+			++total;
+			std::string output;
+			std::string error = translate(source, mode, output);
+			bool ok = test.error == nullptr ? error.empty() : error.find(test.error) != std::string::npos;
+			if (ok and test.code != nullptr and output.find(test.code) == std::string::npos) {
+				++failed;
+				std::cout << "FAIL " << test.name << " [" << mode.name << "]: â êîäå íåò " << test.code << "\n";
+			}
+			else if (!ok) {
+				++failed;
+				std::cout << "FAIL " << test.name << " [" << mode.name << "]: "
+					<< (error.empty() ? "íåò îøèáêè" : error) << "\n";
+			}
+		}
+	}
+
+	std::cout << total - failed << " èç " << total << " ïðîâåðîê ïðîøëè\n";
+	return failed;
+}
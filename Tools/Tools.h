@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Êîìàíäû Tools.exe. Êàæäàÿ âîçâðàùàåò êîä çàâåðøåíèÿ ïðîãðàììû
+
+// Ïðîãíàòü ïðîâåðêè òðàíñëÿòîðà; ÷èñëî óïàâøèõ ïðîâåðîê
+int runTests();
+
+// Îòòðàíñëèðîâàòü íàãðóçî÷íûå ïðîãðàììû (â statements - statementCount îïåðàòîðîâ, 0 - ïî óìîë÷àíèþ);
+// ÷èñëî óïàâøèõ
+int runStress(size_t statementCount);
+// Çàïèñàòü íàãðóçî÷íóþ ïðîãðàììó name èç count ýëåìåíòîâ (0 - ïî óìîë÷àíèþ) â ôàéë
+int generateStress(const std::string& name, size_t count, const std::string& fileName);
+
+// Ñêîðîñòü ïðåæíåãî ñêàíåðà íà switch è òàáëè÷íîãî àâòîìàòà íà òåêñòå ôàéëà, ëó÷øåå èç repeats ïðîõîäîâ
+int runLexerBench(const std::string& fileName, int repeats);
+
+// Ïðîïóñêíàÿ ñïîñîáíîñòü ConcurrentInterner íà 1..64 ïîòîêàõ ïðîòèâ mutex + unordered_map
+// è ïðîâåðêà, ÷òî renumber() íå çàâèñèò îò ðàñïèñàíèÿ; operations - âñòàâîê íà ïîòîê
+int runInternerBench(int operations);
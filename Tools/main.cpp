@@ -0,0 +1,40 @@
+#include <clocale>
+#include <iostream>
+#include <string>
+
+#include "Tools.h"
+
+
+static void usage() {
+	std::cout << "Èñïîëüçîâàíèå:\n"
+		<< "  Tools test - ïðîâåðêè òðàíñëÿòîðà\n"
+		<< "  Tools stress [÷èñëî îïåðàòîðîâ] - íàãðóçî÷íûå ïðîãðàììû: statements, cases, declarators, arguments, chain\n"
+		<< "  Tools generate èìÿ ÷èñëî ôàéë - çàïèñàòü íàãðóçî÷íóþ ïðîãðàììó â ôàéë\n"
+		<< "  Tools lexbench ôàéë [ïðîõîäîâ] - ñêàíåð íà switch ïðîòèâ òàáëè÷íîãî àâòîìàòà\n"
+		<< "  Tools internbench [âñòàâîê íà ïîòîê] - ConcurrentInterner íà 1..64 ïîòîêàõ\n";
+}
+
+
+int main(int argc, char** argv) {
+	setlocale(LC_ALL, "ru");
+
+	if (argc < 2) {
+		usage();
+		return 2;
+	}
+
+	std::string command = argv[1];
+	if (command == "test")
+		return runTests();
+	if (command == "stress")
+		return runStress(argc > 2 ? std::stoul(argv[2]) : 0);
+	if (command == "generate" and argc > 4)
+		return generateStress(argv[2], std::stoul(argv[3]), argv[4]);
+	if (command == "lexbench" and argc > 2)
+		return runLexerBench(argv[2], argc > 3 ? std::stoi(argv[3]) : 10);
+	if (command == "internbench")
+		return runInternerBench(argc > 2 ? std::stoi(argv[2]) : 200000);
+
+	usage();
+	return 2;
+}